@@ -0,0 +1,164 @@
+/*
+ * Enqueue latency of the plugin event queue under an event storm
+ *
+ * Producer threads standing in for the client library threads push event records at a fixed total rate while one
+ * consumer drains them, spending a little time on every record like the event worker does. The time every push takes
+ * is recorded and reported as percentiles, next to the same storm going through a mutex protected std::deque.
+ *
+ * Build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src bench_eventqueue.cpp -o bench_eventqueue -lpthread
+ *   ./bench_eventqueue [events per second] [seconds] [producers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "teamspeak/public_definitions.h"
+#include "eventqueue.h"
+
+#define BENCH_DEFAULT_RATE 100000
+#define BENCH_DEFAULT_SECONDS 2
+#define BENCH_DEFAULT_PRODUCERS 4
+#define BENCH_QUEUE_SIZE 16384  /* EVENT_QUEUE_SIZE */
+#define BENCH_APPLY_NS 2000     /* Time the consumer spends per record */
+
+/* Same layout as struct PluginEvent */
+struct BenchEvent {
+	uint64 serverConnectionHandlerID;
+	uint64 time;
+	uint64 steadyTime;
+	uint64 channelID;
+	uint64 parentID;
+	uint64 oldChannelID;
+	uint64 groupID;
+	uint64 value;
+	anyID clientID;
+	anyID invokerID;
+	unsigned short type;
+	char text[128];
+};
+
+/* The obvious alternative: a deque behind a mutex */
+class LockedQueue {
+public:
+	explicit LockedQueue(size_t capacity) : limit(capacity) {}
+
+	bool push(const struct BenchEvent& event) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (events.size() >= limit) {
+			return false;
+		}
+		events.push_back(event);
+		return true;
+	}
+
+	bool pop(struct BenchEvent* event) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (events.empty()) {
+			return false;
+		}
+		*event = events.front();
+		events.pop_front();
+		return true;
+	}
+
+private:
+	std::mutex mutex;
+	std::deque<struct BenchEvent> events;
+	size_t limit;
+};
+
+static void spin(std::chrono::nanoseconds duration) {
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + duration;
+	while (std::chrono::steady_clock::now() < end) {
+	}
+}
+
+template <typename Queue>
+static void storm(const char* name, Queue* queue, long rate, int seconds, int producers) {
+	std::atomic<bool> done(false);
+	std::atomic<long> consumed(0);
+	std::thread consumer([&]() {
+		struct BenchEvent event;
+		for (;;) {
+			if (queue->pop(&event)) {
+				spin(std::chrono::nanoseconds(BENCH_APPLY_NS));
+				++consumed;
+			}
+			else if (done) {
+				break;
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	const long perProducer = rate * seconds / producers;
+	const std::chrono::nanoseconds interval(1000000000LL * producers / rate);
+	std::vector<std::vector<long> > latencies(producers);
+	std::atomic<long> dropped(0);
+	std::vector<std::thread> threads;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int p = 0; p < producers; ++p) {
+		threads.push_back(std::thread([&, p]() {
+			std::vector<long>& samples = latencies[p];
+			samples.reserve(perProducer);
+			struct BenchEvent event;
+			memset(&event, 0, sizeof(event));
+			event.serverConnectionHandlerID = 1 + p % 3;
+			strcpy(event.text, "Server Admin");
+			std::chrono::steady_clock::time_point next = start + interval * p / producers;
+			for (long i = 0; i < perProducer; ++i) {
+				while (std::chrono::steady_clock::now() < next) {
+				}
+				next += interval;
+				event.clientID = (anyID)i;
+				const std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+				const bool pushed = queue->push(event);
+				samples.push_back((long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count());
+				if (!pushed) {
+					++dropped;
+				}
+			}
+		}));
+	}
+	for (size_t i = 0; i < threads.size(); ++i) {
+		threads[i].join();
+	}
+	done = true;
+	consumer.join();
+
+	std::vector<long> all;
+	for (int p = 0; p < producers; ++p) {
+		all.insert(all.end(), latencies[p].begin(), latencies[p].end());
+	}
+	std::sort(all.begin(), all.end());
+	const size_t n = all.size();
+	printf("%-22s %8zu events  p50 %6ld ns  p99 %6ld ns  p99.9 %7ld ns  max %8ld ns  dropped %ld\n",
+	       name, n, all[n / 2], all[n * 99 / 100], all[n * 999 / 1000], all[n - 1], (long)dropped);
+}
+
+int main(int argc, char** argv) {
+	const long rate = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_RATE;
+	const int seconds = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_SECONDS;
+	const int producers = argc > 3 ? atoi(argv[3]) : BENCH_DEFAULT_PRODUCERS;
+	if (rate <= 0 || seconds <= 0 || producers <= 0) {
+		fprintf(stderr, "usage: %s [events per second] [seconds] [producers]\n", argv[0]);
+		return 1;
+	}
+	printf("%ld events/s for %d s from %d producers, %d ns work per event\n", rate, seconds, producers, BENCH_APPLY_NS);
+
+	EventQueue<struct BenchEvent> eventQueue(BENCH_QUEUE_SIZE);
+	storm("EventQueue", &eventQueue, rate, seconds, producers);
+	LockedQueue lockedQueue(BENCH_QUEUE_SIZE);
+	storm("mutex + std::deque", &lockedQueue, rate, seconds, producers);
+	return 0;
+}
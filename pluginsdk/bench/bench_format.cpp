@@ -0,0 +1,110 @@
+/*
+ * Microbenchmark of the info value formatting
+ *
+ * Compares the former path (convertoString through std::to_string, appended to a std::string) with TextWriter writing
+ * into a fixed buffer, for plain numbers, byte counts and dates. Heap allocations are counted by replacing the global
+ * operator new.
+ *
+ * Build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/infoformat.cpp bench_format.cpp -o bench_format
+ *   ./bench_format [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include "infoformat.h"
+
+#define BENCH_DEFAULT_ITERATIONS 2000000
+
+static unsigned long long allocations = 0;
+
+void* operator new(size_t size) {
+	++allocations;
+	void* pointer = malloc(size ? size : 1);
+	if (!pointer) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+	free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	free(pointer);
+}
+
+/* The formatting used before TextWriter */
+template <typename T>
+std::string convertoString(T a) {
+	return std::to_string(a);
+}
+
+static volatile size_t sink;
+
+template <typename Body>
+static void run(const char* name, long iterations, Body body) {
+	const unsigned long long allocationsBefore = allocations;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (long i = 0; i < iterations; ++i) {
+		body((uint64)i * 2654435761u);
+	}
+	const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	printf("%-34s %8.1f ns/op  %6.2f allocations/op\n", name, ns / iterations, (double)(allocations - allocationsBefore) / iterations);
+}
+
+int main(int argc, char** argv) {
+	const long iterations = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_ITERATIONS;
+
+	run("number: to_string + std::string", iterations, [](uint64 value) {
+		std::string infodata;
+		infodata += "CLIENT_TOTAL_BYTES_UPLOADED = ";
+		infodata += convertoString<uint64>(value);
+		infodata += "\n";
+		sink = infodata.length();
+	});
+	run("number: TextWriter", iterations, [](uint64 value) {
+		char buffer[128];
+		TextWriter out(buffer, sizeof(buffer));
+		out.append("CLIENT_TOTAL_BYTES_UPLOADED = ");
+		out.appendNumber(value);
+		out.append('\n');
+		sink = out.length();
+	});
+	run("bytes: TextWriter", iterations, [](uint64 value) {
+		char buffer[128];
+		TextWriter out(buffer, sizeof(buffer));
+		out.appendBytes(value << 8);
+		sink = out.length();
+	});
+	run("date: TextWriter", iterations, [](uint64 value) {
+		char buffer[128];
+		TextWriter out(buffer, sizeof(buffer));
+		out.appendDate(1500000000 + value % 100000000);
+		sink = out.length();
+	});
+	run("duration: TextWriter", iterations, [](uint64 value) {
+		char buffer[128];
+		TextWriter out(buffer, sizeof(buffer));
+		out.appendDuration(value % 100000000);
+		sink = out.length();
+	});
+
+	/* Samples, to eyeball the output */
+	const uint64 samples[] = { 0, 1023, 1024, 1536, 1572864, 5368709120ULL, 1500000000 };
+	for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); ++i) {
+		char buffer[128];
+		TextWriter out(buffer, sizeof(buffer));
+		out.appendBytes(samples[i]);
+		out.append(" | ");
+		out.appendDate(samples[i]);
+		out.append(" | ");
+		out.appendDuration(samples[i]);
+		printf("%llu: %.*s\n", (unsigned long long)samples[i], (int)out.length(), out.data());
+	}
+	return 0;
+}
@@ -0,0 +1,351 @@
+/*
+ * Latency and allocation benchmark of ts3plugin_infoData
+ *
+ * Renders the server, a channel and a client of a fake host server (fakehost.h) with 10, 1000 and 10000 clients.
+ * Every item is measured twice:
+ *   changed  the item was updated before every render, like the repaint the client asks for after a change
+ *   cached   nothing changed since the last render, the stored text is handed out again
+ * For each the latency percentiles, the heap allocations and TS3Functions calls per render and the length of the text
+ * are reported. Allocations are counted in malloc, calloc and realloc, so operator new, strdup, the text handed out
+ * and the strings the fake host returns like the client library are all included. Calls made by the event worker while
+ * applying the updates are not counted.
+ *
+ * With --save the results are written to a baseline file; with --baseline a run is compared against one, and every
+ * latency percentile worse by more than the tolerance, any additional allocation or call, or a text grown by more
+ * than BENCH_BYTES_TOLERANCE percent is reported as a regression and makes the benchmark exit with 2.
+ *
+ * Linux only, build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/plugin.cpp ../src/infoformat.cpp ../src/profiles.cpp ../src/world.cpp ../src/journal.cpp ../src/talktime.cpp ../src/stringpool.cpp ../src/namecache.cpp ../src/requests.cpp fakehost.cpp bench_infodata.cpp -o bench_infodata -lpthread
+ *   ./bench_infodata [--samples n] [--latency ns] [--save path] [--baseline path] [--tolerance percent]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "teamspeak/public_errors.h"
+#include "teamspeak/public_definitions.h"
+#include "teamspeak/public_rare_definitions.h"
+#include "teamspeak/clientlib_publicdefinitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "fakehost.h"
+
+#define BENCH_SCHID 1
+#define BENCH_DEFAULT_SAMPLES 1000
+#define BENCH_DEFAULT_TOLERANCE 25  /* Percent the latency may grow before it counts as a regression */
+#define BENCH_BYTES_TOLERANCE 10
+#define BENCH_LINE_BUFSIZE 256
+#define BENCH_JOURNAL_SEGMENTS 8    /* JOURNAL_SEGMENTS of the plugin, removed when done */
+
+static const unsigned int scales[] = { 10, 1000, 10000 };
+
+/* Only allocations of the benchmark thread while rendering are counted */
+static thread_local bool counting = false;
+static unsigned long long allocations = 0;
+
+/* The allocator of glibc, the functions below replace its public names for the whole process */
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void __libc_free(void* pointer);
+
+extern "C" void* malloc(size_t size) {
+	if (counting) {
+		++allocations;
+	}
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+	if (counting) {
+		++allocations;
+	}
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+	if (counting) {
+		++allocations;
+	}
+	return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void* pointer) {
+	__libc_free(pointer);
+}
+
+struct BenchResult {
+	long p50;
+	long p99;
+	long max;
+	double allocations;  /* Per render */
+	double calls;
+	double bytes;
+};
+
+/* Prepares a sample and returns the ID of the item to render */
+typedef uint64 (*Prepare)(unsigned int sample, unsigned int clients, unsigned int channels);
+
+static uint64 serverChanged(unsigned int sample, unsigned int clients, unsigned int channels) {
+	fakeHostUpdateServer(BENCH_SCHID);
+	fakeHostSync(BENCH_SCHID);
+	return 0;
+}
+
+static uint64 channelChanged(unsigned int sample, unsigned int clients, unsigned int channels) {
+	const uint64 channelID = 1 + sample % channels;
+	fakeHostUpdateChannel(BENCH_SCHID, channelID);
+	fakeHostSync(BENCH_SCHID);
+	return channelID;
+}
+
+static uint64 clientChanged(unsigned int sample, unsigned int clients, unsigned int channels) {
+	const anyID clientID = (anyID)(1 + sample % clients);
+	fakeHostAnswerRequests();  /* Of earlier renders */
+	fakeHostUpdateClient(BENCH_SCHID, clientID);
+	fakeHostSync(BENCH_SCHID);
+	return clientID;
+}
+
+static uint64 serverCached(unsigned int sample, unsigned int clients, unsigned int channels) {
+	return 0;
+}
+
+static uint64 channelCached(unsigned int sample, unsigned int clients, unsigned int channels) {
+	return 1 + sample % channels;
+}
+
+static uint64 clientCached(unsigned int sample, unsigned int clients, unsigned int channels) {
+	return 1 + sample % clients;
+}
+
+static size_t render(enum PluginItemType type, uint64 id) {
+	char* data = NULL;
+	ts3plugin_infoData(BENCH_SCHID, id, type, &data);
+	const size_t length = data ? strlen(data) : 0;
+	if (data) {
+		ts3plugin_freeMemory(data);
+	}
+	return length;
+}
+
+static struct BenchResult measure(enum PluginItemType type, Prepare prepare, bool warm, unsigned int samples, unsigned int clients, unsigned int channels) {
+	std::vector<long> latencies;
+	latencies.reserve(samples);
+	unsigned long long allocationCount = 0;
+	unsigned long long callCount = 0;
+	unsigned long long byteCount = 0;
+	for (unsigned int i = 0; i < samples; ++i) {
+		const uint64 id = prepare(i, clients, channels);
+		if (warm) {
+			render(type, id);
+		}
+
+		const unsigned long long allocationsBefore = allocations;
+		const unsigned long long callsBefore = fakeHostCalls();
+		counting = true;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		char* data = NULL;
+		ts3plugin_infoData(BENCH_SCHID, id, type, &data);
+		latencies.push_back((long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		counting = false;
+		allocationCount += allocations - allocationsBefore;
+		callCount += fakeHostCalls() - callsBefore;
+		if (data) {
+			byteCount += strlen(data);
+			ts3plugin_freeMemory(data);
+		}
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	struct BenchResult result;
+	result.p50 = latencies[samples / 2];
+	result.p99 = latencies[samples * 99 / 100];
+	result.max = latencies[samples - 1];
+	result.allocations = (double)allocationCount / samples;
+	result.calls = (double)callCount / samples;
+	result.bytes = (double)byteCount / samples;
+	return result;
+}
+
+static bool loadBaseline(const char* path, std::map<std::string, struct BenchResult>* baseline) {
+	FILE* file = fopen(path, "r");
+	if (!file) {
+		return false;
+	}
+	char line[BENCH_LINE_BUFSIZE];
+	char name[BENCH_LINE_BUFSIZE];
+	while (fgets(line, sizeof(line), file)) {
+		struct BenchResult result;
+		if (line[0] != '#' && sscanf(line, "%255s %ld %ld %ld %lf %lf %lf", name, &result.p50, &result.p99, &result.max,
+		                             &result.allocations, &result.calls, &result.bytes) == 7) {
+			(*baseline)[name] = result;
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+static bool saveBaseline(const char* path, const std::vector<std::pair<std::string, struct BenchResult> >& results) {
+	FILE* file = fopen(path, "w");
+	if (!file) {
+		return false;
+	}
+	fprintf(file, "# ts3plugin_infoData baseline: name p50 p99 max (ns) heap allocations calls bytes (per render)\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const struct BenchResult& result = results[i].second;
+		fprintf(file, "%s %ld %ld %ld %.2f %.2f %.1f\n", results[i].first.c_str(), result.p50, result.p99, result.max,
+		        result.allocations, result.calls, result.bytes);
+	}
+	return fclose(file) == 0;
+}
+
+/* Print what got worse than the baseline, returns the number of regressions */
+static int compare(const std::string& name, const struct BenchResult& result, const struct BenchResult& base, double tolerance) {
+	int regressions = 0;
+	if (result.p50 > base.p50 * (1 + tolerance / 100)) {
+		printf("REGRESSION %s: p50 %ld ns, baseline %ld ns\n", name.c_str(), result.p50, base.p50);
+		++regressions;
+	}
+	if (result.p99 > base.p99 * (1 + tolerance / 100)) {
+		printf("REGRESSION %s: p99 %ld ns, baseline %ld ns\n", name.c_str(), result.p99, base.p99);
+		++regressions;
+	}
+	if (result.allocations > base.allocations + 0.01) {
+		printf("REGRESSION %s: %.2f heap allocations, baseline %.2f\n", name.c_str(), result.allocations, base.allocations);
+		++regressions;
+	}
+	if (result.calls > base.calls + 0.01) {
+		printf("REGRESSION %s: %.2f calls, baseline %.2f\n", name.c_str(), result.calls, base.calls);
+		++regressions;
+	}
+	if (result.bytes > base.bytes * (1 + BENCH_BYTES_TOLERANCE / 100.0)) {
+		printf("REGRESSION %s: %.0f bytes, baseline %.0f\n", name.c_str(), result.bytes, base.bytes);
+		++regressions;
+	}
+	return regressions;
+}
+
+static void removeConfig(const std::string& directory) {
+	remove((directory + "/Informations.ini").c_str());
+	remove((directory + "/Informations.journal").c_str());
+	for (int i = 1; i < BENCH_JOURNAL_SEGMENTS; ++i) {
+		remove((directory + "/Informations.journal." + std::to_string(i)).c_str());
+	}
+	remove((directory + "/Informations.fakehostserver" + std::to_string(BENCH_SCHID) + "AAAAAAAAAAAA=.names").c_str());  /* Name cache */
+	rmdir(directory.c_str());
+}
+
+int main(int argc, char** argv) {
+	unsigned int samples = BENCH_DEFAULT_SAMPLES;
+	unsigned int latencyNs = 0;
+	double tolerance = BENCH_DEFAULT_TOLERANCE;
+	const char* savePath = NULL;
+	const char* baselinePath = NULL;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+			samples = (unsigned int)atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+			latencyNs = (unsigned int)atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+			tolerance = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+			savePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+			baselinePath = argv[++i];
+		}
+		else {
+			samples = 0;
+			break;
+		}
+	}
+	if (samples == 0) {
+		fprintf(stderr, "usage: %s [--samples n] [--latency ns] [--save path] [--baseline path] [--tolerance percent]\n", argv[0]);
+		return 1;
+	}
+	std::map<std::string, struct BenchResult> baseline;
+	if (baselinePath && !loadBaseline(baselinePath, &baseline)) {
+		fprintf(stderr, "Cannot read baseline %s\n", baselinePath);
+		return 1;
+	}
+
+	/* Profiles, journal and name cache of the plugin go to a directory of their own, the default profile is used */
+	char directory[] = "/tmp/bench_infodataXXXXXX";
+	if (!mkdtemp(directory)) {
+		perror("mkdtemp");
+		return 1;
+	}
+
+	static const struct {
+		const char* name;
+		enum PluginItemType type;
+		Prepare changed;
+		Prepare cached;
+	} items[] = {
+		{ "server", PLUGIN_SERVER, serverChanged, serverCached },
+		{ "channel", PLUGIN_CHANNEL, channelChanged, channelCached },
+		{ "client", PLUGIN_CLIENT, clientChanged, clientCached },
+	};
+
+	std::vector<std::pair<std::string, struct BenchResult> > results;
+	int regressions = 0;
+	printf("%u samples per line, %u ns per TS3Functions call\n", samples, latencyNs);
+	for (size_t s = 0; s < sizeof(scales) / sizeof(scales[0]); ++s) {
+		struct FakeHostConfig config;
+		config.servers = 1;
+		config.clients = scales[s];
+		config.channels = scales[s] / 10 > FAKEHOST_ROOT_CHANNELS ? scales[s] / 10 : FAKEHOST_ROOT_CHANNELS;
+		config.latencyNs = latencyNs;
+		config.connected = true;  /* Connecting would queue one event per client, more than the queue holds at 10000 */
+		config.configPath = directory;
+		ts3plugin_setFunctionPointers(fakeHostSetup(config));
+		if (ts3plugin_init() != 0) {
+			fprintf(stderr, "ts3plugin_init failed\n");
+			return 1;
+		}
+		ts3plugin_registerPluginID("fakehost");
+		fakeHostSync(BENCH_SCHID);  /* The worker seeded the world and requested the group lists */
+		fakeHostAnswerRequests();
+		fakeHostSync(BENCH_SCHID);
+
+		for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); ++i) {
+			for (int warm = 0; warm < 2; ++warm) {
+				char name[BENCH_LINE_BUFSIZE];
+				snprintf(name, sizeof(name), "%s/%s/%u", items[i].name, warm ? "cached" : "changed", scales[s]);
+				const struct BenchResult result = measure(items[i].type, warm ? items[i].cached : items[i].changed, warm != 0, samples, config.clients, config.channels);
+				printf("%-22s p50 %8ld ns  p99 %8ld ns  max %9ld ns  %6.2f heap allocations  %6.2f calls  %6.0f bytes\n",
+				       name, result.p50, result.p99, result.max, result.allocations, result.calls, result.bytes);
+				results.push_back(std::make_pair(std::string(name), result));
+				std::map<std::string, struct BenchResult>::const_iterator base = baseline.find(name);
+				if (base != baseline.end()) {
+					regressions += compare(name, result, base->second, tolerance);
+				}
+			}
+		}
+
+		ts3plugin_shutdown();
+		if (fakeHostOutstanding() != 0) {
+			printf("%lld library buffers never released\n", fakeHostOutstanding());
+		}
+	}
+	removeConfig(directory);
+
+	if (savePath && !saveBaseline(savePath, results)) {
+		fprintf(stderr, "Cannot write baseline %s\n", savePath);
+		return 1;
+	}
+	if (baselinePath) {
+		printf("%d regressions against %s\n", regressions, baselinePath);
+	}
+	return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Size and speed of the event journal
+ *
+ * Writes the same synthetic event stream, mostly talk status changes and moves with the odd text message, once through
+ * JournalWriter and once as the text lines a plain log would have, then reads the journal back through JournalReader.
+ * Reports the bytes per record of both, the write throughput and the read throughput.
+ *
+ * Build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/journal.cpp bench_journal.cpp -o bench_journal
+ *   ./bench_journal [records] [directory]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include "journal.h"
+
+#define BENCH_DEFAULT_RECORDS 1000000
+#define BENCH_SEGMENT_SIZE (1024 * 1024 * 1024)  /* No rotation, the whole stream stays in one file */
+#define BENCH_BUFFER_SIZE (64 * 1024)
+#define BENCH_START_TIME 1700000000000ULL
+
+static const char* const messages[] = { "hi", "brb", "anyone up for a round?", "moving to the music channel" };
+
+/* Deterministic event stream, roughly what a busy server produces */
+static void makeRecord(unsigned long i, unsigned long* random, struct JournalRecord* record) {
+	*random = *random * 6364136223846793005UL + 1442695040888963407UL;
+	const unsigned long r = *random >> 33;
+	memset(record, 0, sizeof(*record));
+	record->time = BENCH_START_TIME + i * 40 + r % 40;
+	record->serverConnectionHandlerID = 1 + r % 2;
+	record->clientID = 1 + r % 400;
+	switch (r % 10) {
+	case 0: case 1: case 2: case 3: case 4: case 5:
+		record->type = JOURNAL_TALK_STATUS;
+		record->value = r & 1;
+		break;
+	case 6: case 7:
+		record->type = JOURNAL_CLIENT_MOVED;
+		record->channelID = 1 + r % 120;
+		record->otherChannelID = 1 + (r >> 8) % 120;
+		break;
+	case 8:
+		record->type = JOURNAL_CLIENT_UPDATED;
+		break;
+	default:
+		record->type = JOURNAL_TEXT_MESSAGE;
+		record->value = 1 + r % 3;
+		record->invokerID = 1 + (r >> 8) % 400;
+		record->text = messages[r % 4];
+		record->textLength = strlen(record->text);
+		break;
+	}
+}
+
+/* The same record as a line of a text log */
+static int formatLine(const struct JournalRecord& record, char* line, size_t size) {
+	char date[32];
+	const time_t seconds = (time_t)(record.time / 1000);
+	struct tm local;
+#ifdef _WIN32
+	localtime_s(&local, &seconds);
+#else
+	localtime_r(&seconds, &local);
+#endif
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local);
+	return snprintf(line, size, "%s.%03u server=%llu type=%s client=%llu channel=%llu from=%llu invoker=%llu value=%llu text=\"%.*s\"\n",
+	                date, (unsigned int)(record.time % 1000), (unsigned long long)record.serverConnectionHandlerID,
+	                journalTypeName(record.type), (unsigned long long)record.clientID, (unsigned long long)record.channelID,
+	                (unsigned long long)record.otherChannelID, (unsigned long long)record.invokerID,
+	                (unsigned long long)record.value, (int)record.textLength, record.text ? record.text : "");
+}
+
+static long fileSize(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return -1;
+	}
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	const long records = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_RECORDS;
+	const std::string directory = argc > 2 ? argv[2] : ".";
+	if (records <= 0) {
+		fprintf(stderr, "usage: %s [records] [directory]\n", argv[0]);
+		return 1;
+	}
+	const std::string journalPath = directory + "/bench.journal";
+	const std::string textPath = directory + "/bench.log";
+	struct JournalRecord record;
+	unsigned long random;
+
+	JournalWriter writer;
+	remove(journalPath.c_str());  /* Left over from an aborted run, the writer would continue it */
+	if (!writer.open(journalPath.c_str(), BENCH_SEGMENT_SIZE, 1, BENCH_BUFFER_SIZE)) {
+		return 1;
+	}
+	random = 1;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (long i = 0; i < records; ++i) {
+		makeRecord(i, &random, &record);
+		writer.append(record);
+	}
+	writer.close();
+	const double journalSeconds = seconds(start);
+
+	FILE* text = fopen(textPath.c_str(), "w");
+	if (!text) {
+		return 1;
+	}
+	setvbuf(text, NULL, _IOFBF, BENCH_BUFFER_SIZE);
+	char line[512];
+	random = 1;
+	start = std::chrono::steady_clock::now();
+	for (long i = 0; i < records; ++i) {
+		makeRecord(i, &random, &record);
+		fwrite(line, 1, formatLine(record, line, sizeof(line)), text);
+	}
+	fclose(text);
+	const double textSeconds = seconds(start);
+
+	JournalReader reader;
+	if (!reader.open(journalPath.c_str())) {
+		return 1;
+	}
+	long read = 0;
+	unsigned long long check = 0;
+	start = std::chrono::steady_clock::now();
+	while (reader.next(&record)) {
+		check += record.clientID + record.textLength;
+		++read;
+	}
+	const double readSeconds = seconds(start);
+	reader.close();
+
+	const long journalBytes = fileSize(journalPath.c_str());
+	const long textBytes = fileSize(textPath.c_str());
+	printf("%ld records\n", records);
+	printf("journal  %10ld bytes  %5.1f bytes/record  write %6.1f M records/s\n", journalBytes, (double)journalBytes / records, records / journalSeconds / 1e6);
+	printf("text log %10ld bytes  %5.1f bytes/record  write %6.1f M records/s\n", textBytes, (double)textBytes / records, records / textSeconds / 1e6);
+	printf("journal is %.1fx smaller, read back %ld records at %.1f M records/s (check %llu)\n",
+	       (double)textBytes / journalBytes, read, read / readSeconds / 1e6, check);
+	remove(journalPath.c_str());
+	remove(textPath.c_str());
+	return read == records ? 0 : 1;
+}
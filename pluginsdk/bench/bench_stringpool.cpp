@@ -0,0 +1,186 @@
+/*
+ * Memory benchmark of the string pool
+ *
+ * Fills what the plugin keeps per client (the cached variables of every client info field and the UID of the world
+ * model) for 10000 clients three ways: every value a std::string and the world with its own UID table, every value a
+ * StringPool handle, and the current way, the UID a StringPool handle shared with the world and the other values
+ * std::strings. Interning everything is the smallest but the pool never frees, so texts that change with every update
+ * would pile up in it. The clients get realistic values: unique UIDs and nicknames, a few client versions, badges and
+ * countries, and mostly short flags. Heap usage is taken from mallinfo2.
+ *
+ * Linux only, build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/stringpool.cpp bench_stringpool.cpp -o bench_stringpool
+ *   ./bench_stringpool [clients]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "teamspeak/public_definitions.h"
+#include "stringpool.h"
+
+#define BENCH_DEFAULT_CLIENTS 10000
+#define BENCH_STRING_FIELDS 27  /* String variables of the client info */
+#define BENCH_NUMBER_FIELDS 6   /* Integer variables cached next to them */
+#define BENCH_UID_CHARS 27      /* Base64 characters of a UID before the padding */
+
+/* Mirrors of the property cache of plugin.cpp: the first and an interning only one, the current one */
+struct StringValue {
+	int asInt;
+	uint64 asUInt64;
+	std::string asString;
+};
+
+struct HandleValue {
+	int asInt;
+	uint64 asUInt64;
+	unsigned int asString;
+};
+
+struct PropertyValue {
+	int asInt;
+	uint64 asUInt64;
+	unsigned int asIdentifier;
+	std::string asString;
+};
+
+static const char* const versions[] = {
+	"3.6.2 [Build: 1695203293]",
+	"3.6.1 [Build: 1690193193]",
+	"3.5.6 [Build: 1606312422]",
+	"5.0.0-beta.77 [Build: 1641981813]",
+};
+static const char* const versionSigns[] = {
+	"Xezc/LKMq9D8M1zcDjLgEd2OWdbcoeQzN1Ld8lD+Lmn2fdZPj9L1fm3G5nEBFSL4qMbmUYwDZhS4v6gD9sGFCg==",
+	"z7CUhm0t4QN2/l98f+ZoqNxQF8B2Fvkns4YjdsqSqQB31hDdPnSXVdiS+lPm+Yh5O6V4Yo4tNNyW7Ejlm5XBCg==",
+	"rmExZMrUgP7lz6Gv82AxIsS2znc+73GQdI+AImU5fyULA/H18NVGoXwZ5nMo1KQf2eAZQkBPiH6xfB4zzp9PDg==",
+	"KrXcwAUPo/TVSKAE8Ho6zJmUgTAtn3tHsFYHuWjjXVGR6yLb0jCZXeD7vnv0yVlhHf9tr4GmE1xQDmRQjm0LBw==",
+};
+static const char* const badges[] = {
+	"",
+	"overwolf=0",
+	"overwolf=0:badges=c9e97536-5a2d-4c8e-a135-af404587a472",
+	"overwolf=1:badges=50bbdbc8-0f2a-46eb-9808-602225b49627,d95f9901-c42d-4bac-8849-7164fd9e2310",
+};
+static const char* const countries[] = { "DE", "US", "GB", "FR", "PL", "NL", "SE", "RU", "BR", "" };
+static const char* const serverGroups[] = { "8", "6,8", "8,12", "7" };
+
+static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t heapBytes() {
+	const struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+/* The string variables of a client, in the order of the info fields */
+static void clientStrings(unsigned int client, std::vector<std::string>* values) {
+	values->clear();
+	std::string uid;
+	unsigned long random = client * 2654435761ul + 12345;
+	for (int i = 0; i < BENCH_UID_CHARS; ++i) {
+		random = random * 6364136223846793005ul + 1442695040888963407ul;
+		uid += base64[(random >> 33) % 64];
+	}
+	uid += '=';
+	values->push_back(uid);
+	values->push_back("Player " + std::to_string(client));                   /* Nickname */
+	values->push_back("");                                                    /* Phonetic nickname */
+	values->push_back(versions[client % 4]);
+	values->push_back(versionSigns[client % 4]);
+	values->push_back(badges[client % 4]);
+	values->push_back(serverGroups[client % 4]);
+	values->push_back(countries[client % 10]);
+	values->push_back(client % 3 ? "" : "2ef0b4cbc3e4fb5ba1e0f7e6d8ca21c4");  /* Avatar */
+	values->push_back(client % 20 ? "" : "back in 5");                       /* Away message */
+	values->push_back("");                                                    /* Meta data */
+	values->push_back(client % 5 ? "75" : "0");                               /* Talk power */
+	values->push_back("75");                                                  /* Needed query view power */
+	values->push_back("0");                                                   /* Icon */
+	values->push_back(std::to_string(client % 50 + 1));                      /* Inherited channel group channel */
+	while (values->size() < BENCH_STRING_FIELDS) {                           /* Flags */
+		values->push_back((client + values->size()) % 7 ? "0" : "1");
+	}
+}
+
+int main(int argc, char** argv) {
+	const unsigned int clients = argc > 1 ? (unsigned int)atoi(argv[1]) : BENCH_DEFAULT_CLIENTS;
+	std::vector<std::string> values;
+
+	/* Before: std::string values, UIDs also in the UID table of the world */
+	size_t start = heapBytes();
+	{
+		std::unordered_map<anyID, std::unordered_map<size_t, struct StringValue> > cache;
+		std::vector<std::string> uids;
+		std::unordered_map<std::string, unsigned int> uidHandles;
+		for (unsigned int client = 1; client <= clients; ++client) {
+			clientStrings(client, &values);
+			std::unordered_map<size_t, struct StringValue>& properties = cache[(anyID)client];
+			for (size_t i = 0; i < values.size(); ++i) {
+				properties[(i << 2) | 2].asString = values[i];
+			}
+			for (size_t i = 0; i < BENCH_NUMBER_FIELDS; ++i) {
+				properties[((BENCH_STRING_FIELDS + i) << 2) | 1].asUInt64 = client;
+			}
+			if (uidHandles.find(values[0]) == uidHandles.end()) {
+				uids.push_back(values[0]);
+				uidHandles.insert(std::make_pair(values[0], (unsigned int)uids.size() - 1));
+			}
+		}
+		const size_t used = heapBytes() - start;
+		printf("std::string        %10zu bytes  %7.1f bytes per client\n", used, (double)used / clients);
+	}
+
+	/* Handles, one pool for everything */
+	start = heapBytes();
+	{
+		StringPool* pool = new StringPool();
+		std::unordered_map<anyID, std::unordered_map<size_t, struct HandleValue> > cache;
+		std::vector<unsigned int> worldUIDs;
+		for (unsigned int client = 1; client <= clients; ++client) {
+			clientStrings(client, &values);
+			std::unordered_map<size_t, struct HandleValue>& properties = cache[(anyID)client];
+			for (size_t i = 0; i < values.size(); ++i) {
+				properties[(i << 2) | 2].asString = pool->intern(values[i].data(), values[i].length());
+			}
+			for (size_t i = 0; i < BENCH_NUMBER_FIELDS; ++i) {
+				properties[((BENCH_STRING_FIELDS + i) << 2) | 1].asUInt64 = client;
+			}
+			worldUIDs.push_back(pool->intern(values[0].data(), values[0].length()));
+		}
+		const size_t used = heapBytes() - start;
+		printf("StringPool handles %10zu bytes  %7.1f bytes per client\n", used, (double)used / clients);
+		printf("pool: %zu strings in %zu bytes, %.1f bytes per client\n", pool->size(), pool->bytes(), (double)pool->bytes() / clients);
+		delete pool;
+	}
+
+	/* Current: the UID interned and shared with the world, the other values owned by the cache */
+	start = heapBytes();
+	{
+		StringPool* pool = new StringPool();
+		std::unordered_map<anyID, std::unordered_map<size_t, struct PropertyValue> > cache;
+		std::vector<unsigned int> worldUIDs;
+		for (unsigned int client = 1; client <= clients; ++client) {
+			clientStrings(client, &values);
+			std::unordered_map<size_t, struct PropertyValue>& properties = cache[(anyID)client];
+			const unsigned int uid = pool->intern(values[0].data(), values[0].length());
+			properties[2].asIdentifier = uid;
+			for (size_t i = 1; i < values.size(); ++i) {
+				struct PropertyValue& value = properties[(i << 2) | 2];
+				value.asIdentifier = STRING_POOL_NONE;
+				value.asString = values[i];
+			}
+			for (size_t i = 0; i < BENCH_NUMBER_FIELDS; ++i) {
+				properties[((BENCH_STRING_FIELDS + i) << 2) | 1].asUInt64 = client;
+			}
+			worldUIDs.push_back(uid);
+		}
+		const size_t used = heapBytes() - start;
+		printf("UID handles        %10zu bytes  %7.1f bytes per client\n", used, (double)used / clients);
+		printf("pool: %zu strings in %zu bytes, %.1f bytes per client\n", pool->size(), pool->bytes(), (double)pool->bytes() / clients);
+		delete pool;
+	}
+	return 0;
+}
@@ -0,0 +1,700 @@
+/*
+ * Stand-in for the TeamSpeak client: a TS3Functions table answering from synthetic servers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "teamspeak/public_errors.h"
+#include "teamspeak/public_errors_rare.h"
+#include "teamspeak/public_definitions.h"
+#include "teamspeak/public_rare_definitions.h"
+#include "teamspeak/clientlib_publicdefinitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "fakehost.h"
+
+#define FAKEHOST_VALUE_BUFSIZE 64
+#define FAKEHOST_RETURNCODE_BUFSIZE 64
+#define FAKEHOST_SERVER_GROUPS "6,8"
+#define FAKEHOST_CLIENT_UID "fakehost%llu-%05uAAAAAAAAAA="  /* Server connection handler and client ID */
+#define FAKEHOST_DATABASE_ID_BASE 100   /* Database ID of client n is this + n */
+#define FAKEHOST_OWN_CLIENT 1
+#define FAKEHOST_SYNC_CLIENT 65535      /* Connection info of this client marks the worker reaching fakeHostSync */
+#define FAKEHOST_SYNC_TIMEOUT_MS 5000
+
+struct FakeServer {
+	bool connected = false;
+	std::unordered_map<uint64, uint64> channels;  /* Channel ID -> parent */
+	std::unordered_map<anyID, uint64> clients;    /* Client ID -> channel */
+	std::unordered_set<anyID> talking;
+	uint64 nextChannelID = 1;
+	std::map<std::pair<uint64, size_t>, std::string> clientTexts;   /* (Client ID, flag) -> text set by the caller */
+	std::map<std::pair<uint64, size_t>, std::string> channelTexts;
+};
+
+enum FakeRequestType {
+	REQUEST_CONNECTION_INFO,
+	REQUEST_CLIENT_VARIABLES,
+	REQUEST_SERVER_GROUPS,
+	REQUEST_CHANNEL_GROUPS,
+	REQUEST_NAME_FROM_UID,
+	REQUEST_NAME_FROM_DBID,
+};
+
+/* A request of the plugin the client answers with events, see fakeHostAnswerRequests */
+struct FakeRequest {
+	enum FakeRequestType type;
+	uint64 serverConnectionHandlerID;
+	anyID clientID;
+	char returnCode[FAKEHOST_RETURNCODE_BUFSIZE];  /* Answered with ts3plugin_onServerErrorEvent after the events, empty for none */
+};
+
+static std::mutex hostMutex;
+static std::map<uint64, struct FakeServer> servers;
+static std::vector<struct FakeRequest> requests;
+static unsigned int latencyNs;
+static std::thread::id setupThread;
+static std::atomic<long long> outstanding(0);
+static std::string configPath;
+static std::atomic<unsigned long> syncs(0);
+static std::atomic<unsigned long long> calls(0);
+
+/* Every call of the table goes through here */
+static void hostCall() {
+	if (std::this_thread::get_id() == setupThread) {
+		++calls;
+	}
+	if (latencyNs == 0) {
+		return;
+	}
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(latencyNs);
+	while (std::chrono::steady_clock::now() < end) {
+	}
+}
+
+static unsigned long nextRandom(unsigned long* random) {
+	*random = *random * 6364136223846793005UL + 1442695040888963407UL;
+	return *random >> 33;
+}
+
+/* Needs hostMutex. Getters may run after a server is gone, they see it empty. */
+static const struct FakeServer& findServer(uint64 schid) {
+	static const struct FakeServer gone;
+	std::map<uint64, struct FakeServer>::const_iterator it = servers.find(schid);
+	return it != servers.end() ? it->second : gone;
+}
+
+static char* libraryString(const char* value) {
+	++outstanding;
+	return strdup(value);
+}
+
+static unsigned int freeMemory(void* pointer) {
+	--outstanding;
+	free(pointer);
+	return ERROR_ok;
+}
+
+/* Copy of a text set with fakeHostSetClientText or fakeHostSetChannelText, NULL if there is none */
+static char* setText(uint64 schid, bool client, uint64 id, size_t flag) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const struct FakeServer& server = findServer(schid);
+	const std::map<std::pair<uint64, size_t>, std::string>& texts = client ? server.clientTexts : server.channelTexts;
+	std::map<std::pair<uint64, size_t>, std::string>::const_iterator it = texts.find(std::make_pair(id, flag));
+	return it != texts.end() ? libraryString(it->second.c_str()) : NULL;
+}
+
+static unsigned int getClientVariableAsString(uint64 schid, anyID clientID, size_t flag, char** result) {
+	hostCall();
+	if ((*result = setText(schid, true, clientID, flag)) != NULL) {
+		return ERROR_ok;
+	}
+	char value[FAKEHOST_VALUE_BUFSIZE];
+	switch (flag) {
+	case CLIENT_NICKNAME:
+		snprintf(value, sizeof(value), "Client %u", (unsigned int)clientID);
+		break;
+	case CLIENT_UNIQUE_IDENTIFIER:
+		snprintf(value, sizeof(value), FAKEHOST_CLIENT_UID, (unsigned long long)schid, (unsigned int)clientID);
+		break;
+	case CLIENT_SERVERGROUPS:
+		snprintf(value, sizeof(value), "%s", FAKEHOST_SERVER_GROUPS);
+		break;
+	default:
+		snprintf(value, sizeof(value), "fake client value");
+		break;
+	}
+	*result = libraryString(value);
+	return ERROR_ok;
+}
+
+static unsigned int getClientVariableAsInt(uint64 schid, anyID clientID, size_t flag, int* result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const struct FakeServer& server = findServer(schid);
+	if (!server.clients.count(clientID)) {
+		return ERROR_client_invalid_id;
+	}
+	switch (flag) {
+	case CLIENT_FLAG_TALKING:
+		*result = server.talking.count(clientID) ? 1 : 0;
+		break;
+	case CLIENT_DATABASE_ID:
+		*result = FAKEHOST_DATABASE_ID_BASE + clientID;
+		break;
+	default:
+		*result = 0;
+		break;
+	}
+	return ERROR_ok;
+}
+
+static unsigned int getClientVariableAsUInt64(uint64 schid, anyID clientID, size_t flag, uint64* result) {
+	hostCall();
+	*result = 0;
+	return ERROR_ok;
+}
+
+static unsigned int getChannelVariableAsString(uint64 schid, uint64 channelID, size_t flag, char** result) {
+	hostCall();
+	if ((*result = setText(schid, false, channelID, flag)) != NULL) {
+		return ERROR_ok;
+	}
+	char value[FAKEHOST_VALUE_BUFSIZE];
+	if (flag == CHANNEL_NAME) {
+		snprintf(value, sizeof(value), "Channel %llu", (unsigned long long)channelID);
+	}
+	else {
+		snprintf(value, sizeof(value), "fake channel value");
+	}
+	*result = libraryString(value);
+	return ERROR_ok;
+}
+
+static unsigned int getChannelVariableAsInt(uint64 schid, uint64 channelID, size_t flag, int* result) {
+	hostCall();
+	*result = 0;
+	return ERROR_ok;
+}
+
+static unsigned int getChannelVariableAsUInt64(uint64 schid, uint64 channelID, size_t flag, uint64* result) {
+	hostCall();
+	*result = 0;
+	return ERROR_ok;
+}
+
+static unsigned int getServerVariableAsString(uint64 schid, size_t flag, char** result) {
+	hostCall();
+	char value[FAKEHOST_VALUE_BUFSIZE];
+	switch (flag) {
+	case VIRTUALSERVER_NAME:
+		snprintf(value, sizeof(value), "Server %llu", (unsigned long long)schid);
+		break;
+	case VIRTUALSERVER_UNIQUE_IDENTIFIER:
+		snprintf(value, sizeof(value), "fakehostserver%lluAAAAAAAAAAAA=", (unsigned long long)schid);
+		break;
+	default:
+		snprintf(value, sizeof(value), "fake server value");
+		break;
+	}
+	*result = libraryString(value);
+	return ERROR_ok;
+}
+
+static unsigned int getServerVariableAsInt(uint64 schid, size_t flag, int* result) {
+	hostCall();
+	*result = 9987;
+	return ERROR_ok;
+}
+
+static unsigned int getServerVariableAsUInt64(uint64 schid, size_t flag, uint64* result) {
+	hostCall();
+	*result = 1;
+	return ERROR_ok;
+}
+
+static unsigned int getConnectionVariableAsString(uint64 schid, anyID clientID, size_t flag, char** result) {
+	hostCall();
+	*result = libraryString("127.0.0.1");
+	return ERROR_ok;
+}
+
+static unsigned int getConnectionVariableAsUInt64(uint64 schid, anyID clientID, size_t flag, uint64* result) {
+	hostCall();
+	*result = 0;
+	return ERROR_ok;
+}
+
+static unsigned int getConnectionVariableAsDouble(uint64 schid, anyID clientID, size_t flag, double* result) {
+	hostCall();
+	if (clientID == FAKEHOST_SYNC_CLIENT && flag == CONNECTION_PING) {
+		++syncs;
+	}
+	*result = 23.0;
+	return ERROR_ok;
+}
+
+static unsigned int getClientID(uint64 schid, anyID* result) {
+	hostCall();
+	*result = FAKEHOST_OWN_CLIENT;
+	return ERROR_ok;
+}
+
+static unsigned int getClientList(uint64 schid, anyID** result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const std::unordered_map<anyID, uint64>& clients = findServer(schid).clients;
+	anyID* list = (anyID*)malloc((clients.size() + 1) * sizeof(anyID));
+	size_t n = 0;
+	for (std::unordered_map<anyID, uint64>::const_iterator it = clients.begin(); it != clients.end(); ++it) {
+		list[n++] = it->first;
+	}
+	list[n] = 0;
+	++outstanding;
+	*result = list;
+	return ERROR_ok;
+}
+
+static unsigned int getChannelList(uint64 schid, uint64** result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const std::unordered_map<uint64, uint64>& channels = findServer(schid).channels;
+	uint64* list = (uint64*)malloc((channels.size() + 1) * sizeof(uint64));
+	size_t n = 0;
+	for (std::unordered_map<uint64, uint64>::const_iterator it = channels.begin(); it != channels.end(); ++it) {
+		list[n++] = it->first;
+	}
+	list[n] = 0;
+	++outstanding;
+	*result = list;
+	return ERROR_ok;
+}
+
+static unsigned int getChannelOfClient(uint64 schid, anyID clientID, uint64* result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const std::unordered_map<anyID, uint64>& clients = findServer(schid).clients;
+	std::unordered_map<anyID, uint64>::const_iterator it = clients.find(clientID);
+	if (it == clients.end()) {
+		return ERROR_client_invalid_id;
+	}
+	*result = it->second;
+	return ERROR_ok;
+}
+
+static unsigned int getParentChannelOfChannel(uint64 schid, uint64 channelID, uint64* result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const std::unordered_map<uint64, uint64>& channels = findServer(schid).channels;
+	std::unordered_map<uint64, uint64>::const_iterator it = channels.find(channelID);
+	if (it == channels.end()) {
+		return ERROR_channel_invalid_id;
+	}
+	*result = it->second;
+	return ERROR_ok;
+}
+
+static unsigned int getServerConnectionHandlerList(uint64** result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	uint64* list = (uint64*)malloc((servers.size() + 1) * sizeof(uint64));
+	size_t n = 0;
+	for (std::map<uint64, struct FakeServer>::const_iterator it = servers.begin(); it != servers.end(); ++it) {
+		if (it->second.connected) {
+			list[n++] = it->first;
+		}
+	}
+	list[n] = 0;
+	++outstanding;
+	*result = list;
+	return ERROR_ok;
+}
+
+static unsigned int getConnectionStatus(uint64 schid, int* result) {
+	hostCall();
+	std::lock_guard<std::mutex> lock(hostMutex);
+	*result = findServer(schid).connected ? STATUS_CONNECTION_ESTABLISHED : STATUS_DISCONNECTED;
+	return ERROR_ok;
+}
+
+static uint64 getCurrentServerConnectionHandlerID() {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	return servers.empty() ? 0 : servers.begin()->first;
+}
+
+static void queueRequest(enum FakeRequestType type, uint64 schid, anyID clientID, const char* returnCode) {
+	struct FakeRequest request;
+	request.type = type;
+	request.serverConnectionHandlerID = schid;
+	request.clientID = clientID;
+	snprintf(request.returnCode, sizeof(request.returnCode), "%s", returnCode ? returnCode : "");
+	std::lock_guard<std::mutex> lock(hostMutex);
+	requests.push_back(request);
+}
+
+static unsigned int requestConnectionInfo(uint64 schid, anyID clientID, const char* returnCode) {
+	hostCall();
+	queueRequest(REQUEST_CONNECTION_INFO, schid, clientID, returnCode);
+	return ERROR_ok;
+}
+
+static unsigned int requestClientVariables(uint64 schid, anyID clientID, const char* returnCode) {
+	hostCall();
+	queueRequest(REQUEST_CLIENT_VARIABLES, schid, clientID, returnCode);
+	return ERROR_ok;
+}
+
+static unsigned int requestServerGroupList(uint64 schid, const char* returnCode) {
+	hostCall();
+	queueRequest(REQUEST_SERVER_GROUPS, schid, 0, returnCode);
+	return ERROR_ok;
+}
+
+static unsigned int requestChannelGroupList(uint64 schid, const char* returnCode) {
+	hostCall();
+	queueRequest(REQUEST_CHANNEL_GROUPS, schid, 0, returnCode);
+	return ERROR_ok;
+}
+
+static unsigned int requestClientNamefromUID(uint64 schid, const char* clientUniqueIdentifier, const char* returnCode) {
+	hostCall();
+	unsigned long long uidSchid;
+	unsigned int clientID;
+	if (sscanf(clientUniqueIdentifier, FAKEHOST_CLIENT_UID, &uidSchid, &clientID) != 2 || uidSchid != schid) {
+		return ERROR_database_empty_result;
+	}
+	queueRequest(REQUEST_NAME_FROM_UID, schid, (anyID)clientID, returnCode);
+	return ERROR_ok;
+}
+
+static unsigned int requestClientNamefromDBID(uint64 schid, uint64 clientDatabaseID, const char* returnCode) {
+	hostCall();
+	if (clientDatabaseID <= FAKEHOST_DATABASE_ID_BASE) {
+		return ERROR_database_empty_result;
+	}
+	queueRequest(REQUEST_NAME_FROM_DBID, schid, (anyID)(clientDatabaseID - FAKEHOST_DATABASE_ID_BASE), returnCode);
+	return ERROR_ok;
+}
+
+/* Unique per call like the client's, the plugin must not rely on the format */
+static void createReturnCode(const char* pluginID, char* returnCode, size_t maxLen) {
+	static std::atomic<unsigned long> returnCodes(0);
+	snprintf(returnCode, maxLen, "PR:%s:%lu", pluginID, ++returnCodes);
+}
+
+static unsigned int requestInfoUpdate(uint64 schid, enum PluginItemType itemType, uint64 itemID) {
+	hostCall();
+	return ERROR_ok;
+}
+
+static void printMessageToCurrentTab(const char* message) {
+	printf("%s\n", message);
+}
+
+static unsigned int logMessage(const char* logMessage, enum LogLevel severity, const char* channel, uint64 logID) {
+	printf("%s: %s\n", channel, logMessage);
+	return ERROR_ok;
+}
+
+static void setPluginMenuEnabled(const char* pluginID, int menuID, int enabled) {
+}
+
+static void getPath(char* path, size_t maxLen) {
+	path[0] = '\0';
+}
+
+static void getConfigPath(char* path, size_t maxLen) {
+	snprintf(path, maxLen, "%s/", configPath.c_str());
+}
+
+struct TS3Functions fakeHostSetup(const struct FakeHostConfig& config) {
+	{
+		std::lock_guard<std::mutex> lock(hostMutex);
+		servers.clear();
+		requests.clear();
+		latencyNs = config.latencyNs;
+		setupThread = std::this_thread::get_id();
+		configPath = config.configPath ? config.configPath : P_tmpdir;
+		unsigned long random = 1;
+		for (uint64 schid = 1; schid <= config.servers; ++schid) {
+			struct FakeServer& server = servers[schid];
+			server.connected = config.connected;
+			for (uint64 channelID = 1; channelID <= config.channels; ++channelID) {
+				server.channels[channelID] = channelID <= FAKEHOST_ROOT_CHANNELS ? 0 : 1 + nextRandom(&random) % (channelID - 1);
+			}
+			server.nextChannelID = config.channels + 1;
+			for (unsigned int clientID = FAKEHOST_OWN_CLIENT; clientID <= config.clients && config.channels > 0; ++clientID) {
+				server.clients[(anyID)clientID] = clientID == FAKEHOST_OWN_CLIENT ? 1 : 1 + nextRandom(&random) % config.channels;
+			}
+		}
+	}
+
+	struct TS3Functions funcs;
+	memset(&funcs, 0, sizeof(funcs));
+	funcs.freeMemory = freeMemory;
+	funcs.getClientVariableAsString = getClientVariableAsString;
+	funcs.getClientVariableAsInt = getClientVariableAsInt;
+	funcs.getClientVariableAsUInt64 = getClientVariableAsUInt64;
+	funcs.getChannelVariableAsString = getChannelVariableAsString;
+	funcs.getChannelVariableAsInt = getChannelVariableAsInt;
+	funcs.getChannelVariableAsUInt64 = getChannelVariableAsUInt64;
+	funcs.getServerVariableAsString = getServerVariableAsString;
+	funcs.getServerVariableAsInt = getServerVariableAsInt;
+	funcs.getServerVariableAsUInt64 = getServerVariableAsUInt64;
+	funcs.getConnectionVariableAsString = getConnectionVariableAsString;
+	funcs.getConnectionVariableAsUInt64 = getConnectionVariableAsUInt64;
+	funcs.getConnectionVariableAsDouble = getConnectionVariableAsDouble;
+	funcs.getClientID = getClientID;
+	funcs.getClientList = getClientList;
+	funcs.getChannelList = getChannelList;
+	funcs.getChannelOfClient = getChannelOfClient;
+	funcs.getParentChannelOfChannel = getParentChannelOfChannel;
+	funcs.getServerConnectionHandlerList = getServerConnectionHandlerList;
+	funcs.getConnectionStatus = getConnectionStatus;
+	funcs.getCurrentServerConnectionHandlerID = getCurrentServerConnectionHandlerID;
+	funcs.requestConnectionInfo = requestConnectionInfo;
+	funcs.requestClientVariables = requestClientVariables;
+	funcs.requestServerGroupList = requestServerGroupList;
+	funcs.requestChannelGroupList = requestChannelGroupList;
+	funcs.requestClientNamefromUID = requestClientNamefromUID;
+	funcs.requestClientNamefromDBID = requestClientNamefromDBID;
+	funcs.requestInfoUpdate = requestInfoUpdate;
+	funcs.createReturnCode = createReturnCode;
+	funcs.printMessageToCurrentTab = printMessageToCurrentTab;
+	funcs.logMessage = logMessage;
+	funcs.setPluginMenuEnabled = setPluginMenuEnabled;
+	funcs.getAppPath = getPath;
+	funcs.getResourcesPath = getPath;
+	funcs.getConfigPath = getConfigPath;
+	funcs.getPluginPath = getPath;
+	return funcs;
+}
+
+long long fakeHostOutstanding() {
+	return outstanding;
+}
+
+unsigned long long fakeHostCalls() {
+	return calls;
+}
+
+bool fakeHostSync(uint64 serverConnectionHandlerID) {
+	const unsigned long before = syncs;
+	ts3plugin_onConnectionInfoEvent(serverConnectionHandlerID, FAKEHOST_SYNC_CLIENT);
+	const std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(FAKEHOST_SYNC_TIMEOUT_MS);
+	while (syncs == before) {
+		if (std::chrono::steady_clock::now() > timeout) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+void fakeHostAnswerRequests() {
+	static std::vector<struct FakeRequest> answering;  /* Keeps the capacity of both, answering allocates nothing */
+	answering.clear();
+	{
+		std::lock_guard<std::mutex> lock(hostMutex);
+		answering.swap(requests);
+	}
+	for (size_t i = 0; i < answering.size(); ++i) {
+		const struct FakeRequest& request = answering[i];
+		const uint64 schid = request.serverConnectionHandlerID;
+		switch (request.type) {
+		case REQUEST_CONNECTION_INFO:
+			ts3plugin_onConnectionInfoEvent(schid, request.clientID);
+			break;
+		case REQUEST_CLIENT_VARIABLES:
+			ts3plugin_onUpdateClientEvent(schid, request.clientID, 0, "", "");
+			break;
+		case REQUEST_SERVER_GROUPS:
+			ts3plugin_onServerGroupListEvent(schid, 6, "Server Admin", 1, 0, 1);
+			ts3plugin_onServerGroupListEvent(schid, 8, "Guest", 1, 0, 1);
+			ts3plugin_onServerGroupListFinishedEvent(schid);
+			break;
+		case REQUEST_CHANNEL_GROUPS:
+			ts3plugin_onChannelGroupListEvent(schid, 5, "Channel Admin", 1, 0, 1);
+			ts3plugin_onChannelGroupListEvent(schid, 8, "Guest", 1, 0, 1);
+			ts3plugin_onChannelGroupListFinishedEvent(schid);
+			break;
+		case REQUEST_NAME_FROM_UID:
+		case REQUEST_NAME_FROM_DBID: {
+			char uid[FAKEHOST_VALUE_BUFSIZE];
+			char nickname[FAKEHOST_VALUE_BUFSIZE];
+			snprintf(uid, sizeof(uid), FAKEHOST_CLIENT_UID, (unsigned long long)schid, (unsigned int)request.clientID);
+			snprintf(nickname, sizeof(nickname), "Client %u", (unsigned int)request.clientID);
+			const uint64 databaseID = FAKEHOST_DATABASE_ID_BASE + request.clientID;
+			if (request.type == REQUEST_NAME_FROM_UID) {
+				ts3plugin_onClientNamefromUIDEvent(schid, uid, databaseID, nickname);
+			}
+			else {
+				ts3plugin_onClientNamefromDBIDEvent(schid, uid, databaseID, nickname);
+			}
+			break;
+		}
+		}
+		if (request.returnCode[0] != '\0') {
+			ts3plugin_onServerErrorEvent(schid, "ok", ERROR_ok, request.returnCode, "");
+		}
+	}
+}
+
+void fakeHostSetConnected(uint64 serverConnectionHandlerID, bool connected) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	servers[serverConnectionHandlerID].connected = connected;
+}
+
+bool fakeHostConnected(uint64 serverConnectionHandlerID) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	return findServer(serverConnectionHandlerID).connected;
+}
+
+void fakeHostPlaceChannel(uint64 serverConnectionHandlerID, uint64 channelID, uint64 parentID) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	struct FakeServer& server = servers[serverConnectionHandlerID];
+	server.channels[channelID] = parentID;
+	if (channelID >= server.nextChannelID) {
+		server.nextChannelID = channelID + 1;
+	}
+}
+
+void fakeHostRemoveChannel(uint64 serverConnectionHandlerID, uint64 channelID) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	servers[serverConnectionHandlerID].channels.erase(channelID);
+}
+
+void fakeHostPlaceClient(uint64 serverConnectionHandlerID, anyID clientID, uint64 channelID) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	struct FakeServer& server = servers[serverConnectionHandlerID];
+	if (channelID == 0) {
+		server.clients.erase(clientID);
+		server.talking.erase(clientID);
+	}
+	else {
+		server.clients[clientID] = channelID;
+	}
+}
+
+void fakeHostSetClientText(uint64 serverConnectionHandlerID, anyID clientID, size_t flag, const char* text) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	servers[serverConnectionHandlerID].clientTexts[std::make_pair((uint64)clientID, flag)] = text;
+}
+
+void fakeHostSetChannelText(uint64 serverConnectionHandlerID, uint64 channelID, size_t flag, const char* text) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	servers[serverConnectionHandlerID].channelTexts[std::make_pair(channelID, flag)] = text;
+}
+
+anyID fakeHostAnyClient(uint64 serverConnectionHandlerID, unsigned long random) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	const std::unordered_map<anyID, uint64>& clients = findServer(serverConnectionHandlerID).clients;
+	if (clients.empty()) {
+		return 0;
+	}
+	std::unordered_map<anyID, uint64>::const_iterator it = clients.begin();
+	std::advance(it, random % (clients.size() < 64 ? clients.size() : 64));  /* Walking further costs more than it is worth */
+	return it->first;
+}
+
+unsigned int fakeHostClientCount(uint64 serverConnectionHandlerID) {
+	std::lock_guard<std::mutex> lock(hostMutex);
+	return (unsigned int)findServer(serverConnectionHandlerID).clients.size();
+}
+
+/* Like the client: the channel list, the clients entering, then established */
+void fakeHostConnect(uint64 serverConnectionHandlerID) {
+	std::vector<std::pair<uint64, uint64> > channels;
+	std::vector<std::pair<anyID, uint64> > clients;
+	{
+		std::lock_guard<std::mutex> lock(hostMutex);
+		struct FakeServer& server = servers[serverConnectionHandlerID];
+		channels.assign(server.channels.begin(), server.channels.end());
+		clients.assign(server.clients.begin(), server.clients.end());
+	}
+	ts3plugin_onConnectStatusChangeEvent(serverConnectionHandlerID, STATUS_CONNECTING, ERROR_ok);
+	ts3plugin_onConnectStatusChangeEvent(serverConnectionHandlerID, STATUS_CONNECTED, ERROR_ok);
+	for (size_t i = 0; i < channels.size(); ++i) {
+		ts3plugin_onNewChannelEvent(serverConnectionHandlerID, channels[i].first, channels[i].second);
+	}
+	ts3plugin_onConnectStatusChangeEvent(serverConnectionHandlerID, STATUS_CONNECTION_ESTABLISHING, ERROR_ok);
+	for (size_t i = 0; i < clients.size(); ++i) {
+		ts3plugin_onClientMoveEvent(serverConnectionHandlerID, clients[i].first, 0, clients[i].second, ENTER_VISIBILITY, "");
+	}
+	fakeHostSetConnected(serverConnectionHandlerID, true);
+	ts3plugin_onConnectStatusChangeEvent(serverConnectionHandlerID, STATUS_CONNECTION_ESTABLISHED, ERROR_ok);
+}
+
+void fakeHostDisconnect(uint64 serverConnectionHandlerID) {
+	fakeHostSetConnected(serverConnectionHandlerID, false);
+	ts3plugin_onConnectStatusChangeEvent(serverConnectionHandlerID, STATUS_DISCONNECTED, ERROR_ok);
+}
+
+void fakeHostMoveClient(uint64 serverConnectionHandlerID, anyID clientID, uint64 channelID) {
+	uint64 oldChannelID = 0;
+	{
+		std::lock_guard<std::mutex> lock(hostMutex);
+		const std::unordered_map<anyID, uint64>& clients = findServer(serverConnectionHandlerID).clients;
+		std::unordered_map<anyID, uint64>::const_iterator it = clients.find(clientID);
+		if (it != clients.end()) {
+			oldChannelID = it->second;
+		}
+	}
+	fakeHostPlaceClient(serverConnectionHandlerID, clientID, channelID);
+	const int visibility = oldChannelID == 0 ? ENTER_VISIBILITY : channelID == 0 ? LEAVE_VISIBILITY : RETAIN_VISIBILITY;
+	ts3plugin_onClientMoveEvent(serverConnectionHandlerID, clientID, oldChannelID, channelID, visibility, "");
+}
+
+void fakeHostSetTalking(uint64 serverConnectionHandlerID, anyID clientID, bool talking) {
+	{
+		std::lock_guard<std::mutex> lock(hostMutex);
+		struct FakeServer& server = servers[serverConnectionHandlerID];
+		if (talking) {
+			server.talking.insert(clientID);
+		}
+		else {
+			server.talking.erase(clientID);
+		}
+	}
+	ts3plugin_onTalkStatusChangeEvent(serverConnectionHandlerID, talking ? STATUS_TALKING : STATUS_NOT_TALKING, 0, clientID);
+}
+
+void fakeHostUpdateClient(uint64 serverConnectionHandlerID, anyID clientID) {
+	ts3plugin_onUpdateClientEvent(serverConnectionHandlerID, clientID, 0, "", "");
+}
+
+void fakeHostUpdateChannel(uint64 serverConnectionHandlerID, uint64 channelID) {
+	ts3plugin_onUpdateChannelEvent(serverConnectionHandlerID, channelID);
+}
+
+void fakeHostUpdateServer(uint64 serverConnectionHandlerID) {
+	ts3plugin_onServerUpdatedEvent(serverConnectionHandlerID);
+}
+
+uint64 fakeHostCreateChannel(uint64 serverConnectionHandlerID, uint64 parentID) {
+	uint64 channelID;
+	{
+		std::lock_guard<std::mutex> lock(hostMutex);
+		struct FakeServer& server = servers[serverConnectionHandlerID];
+		channelID = server.nextChannelID++;
+		server.channels[channelID] = parentID;
+	}
+	ts3plugin_onNewChannelCreatedEvent(serverConnectionHandlerID, channelID, parentID, FAKEHOST_OWN_CLIENT, "", "");
+	return channelID;
+}
+
+void fakeHostDeleteChannel(uint64 serverConnectionHandlerID, uint64 channelID) {
+	fakeHostRemoveChannel(serverConnectionHandlerID, channelID);
+	ts3plugin_onDelChannelEvent(serverConnectionHandlerID, channelID, FAKEHOST_OWN_CLIENT, "", "");
+}
@@ -0,0 +1,69 @@
+/*
+ * Stand-in for the TeamSpeak client: a TS3Functions table answering from synthetic servers, and calls of the
+ * ts3plugin_* callbacks that go with changing them. Lets the benchmarks run the plugin on Linux without a client.
+ */
+
+#ifndef FAKEHOST_H
+#define FAKEHOST_H
+
+#include "teamspeak/public_definitions.h"
+#include "ts3_functions.h"
+
+/*
+ * Server connection handlers are numbered 1 to servers. Each server has channels 1 to channels, the first
+ * FAKEHOST_ROOT_CHANNELS at the top and the others below a random earlier one, and clients 1 to clients spread over
+ * them. Client 1, in channel 1, is the own client.
+ */
+#define FAKEHOST_ROOT_CHANNELS 10
+
+struct FakeHostConfig {
+	unsigned int servers;
+	unsigned int channels;    /* Per server */
+	unsigned int clients;     /* Per server, the own client included */
+	unsigned int latencyNs;   /* Time every call of the table takes */
+	bool connected;           /* Servers are connected when the plugin loads, else fakeHostConnect them */
+	const char* configPath;   /* Returned by getConfigPath, NULL for the temporary directory */
+};
+
+/* Build the servers, forgetting earlier ones, and return the table for ts3plugin_setFunctionPointers */
+struct TS3Functions fakeHostSetup(const struct FakeHostConfig& config);
+
+/* Strings and lists handed to the plugin and not yet released through freeMemory */
+long long fakeHostOutstanding();
+/* Calls of the table from the thread that called fakeHostSetup, the plugin's event worker is not counted */
+unsigned long long fakeHostCalls();
+/* Wait until the plugin's event worker has applied the events posted so far, false after a timeout */
+bool fakeHostSync(uint64 serverConnectionHandlerID);
+/*
+ * Answer the connection info, client variable, group list and name requests of the plugin so far with their events,
+ * then their return codes with ts3plugin_onServerErrorEvent. Like the client, the caller registers the plugin ID after
+ * ts3plugin_init for requests to carry return codes.
+ */
+void fakeHostAnswerRequests();
+
+/* Change the servers without telling the plugin, for callers delivering the callbacks themselves */
+void fakeHostSetConnected(uint64 serverConnectionHandlerID, bool connected);
+bool fakeHostConnected(uint64 serverConnectionHandlerID);
+void fakeHostPlaceChannel(uint64 serverConnectionHandlerID, uint64 channelID, uint64 parentID);
+void fakeHostRemoveChannel(uint64 serverConnectionHandlerID, uint64 channelID);
+void fakeHostPlaceClient(uint64 serverConnectionHandlerID, anyID clientID, uint64 channelID);  /* Channel 0 removes */
+/* Text returned for a string variable of a client or channel from now on, instead of the fake value */
+void fakeHostSetClientText(uint64 serverConnectionHandlerID, anyID clientID, size_t flag, const char* text);
+void fakeHostSetChannelText(uint64 serverConnectionHandlerID, uint64 channelID, size_t flag, const char* text);
+/* Some client on the server picked with random, 0 if there is none */
+anyID fakeHostAnyClient(uint64 serverConnectionHandlerID, unsigned long random);
+/* Clients on the server, as getClientList would list them */
+unsigned int fakeHostClientCount(uint64 serverConnectionHandlerID);
+
+/* Change the servers and call the callback the client would call */
+void fakeHostConnect(uint64 serverConnectionHandlerID);
+void fakeHostDisconnect(uint64 serverConnectionHandlerID);
+void fakeHostMoveClient(uint64 serverConnectionHandlerID, anyID clientID, uint64 channelID);  /* Channel 0 leaves */
+void fakeHostSetTalking(uint64 serverConnectionHandlerID, anyID clientID, bool talking);
+void fakeHostUpdateClient(uint64 serverConnectionHandlerID, anyID clientID);
+void fakeHostUpdateChannel(uint64 serverConnectionHandlerID, uint64 channelID);
+void fakeHostUpdateServer(uint64 serverConnectionHandlerID);
+uint64 fakeHostCreateChannel(uint64 serverConnectionHandlerID, uint64 parentID);
+void fakeHostDeleteChannel(uint64 serverConnectionHandlerID, uint64 channelID);
+
+#endif
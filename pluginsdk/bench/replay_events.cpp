@@ -0,0 +1,583 @@
+/*
+ * Headless callback replayer
+ *
+ * Drives the ts3plugin_* entry points of plugin.h with an event trace, without a TeamSpeak client. The trace is either
+ * recorded, one or more journal segments as written by the plugin, or generated:
+ *   restart    a server coming back after a restart: the channel list, then every client joining with its update
+ *              and a few talk status changes
+ *   churn      a busy server in steady state: talking, moves, updates, text messages, clients leaving and rejoining
+ *   subscribe  a server with only some channels subscribed: channels subscribed and unsubscribed, their clients
+ *              coming into and going out of view, talking in between. At the end the client count the plugin shows
+ *              is checked against the clients in view, exiting with 1 if they differ
+ * Gap records of a journal, where the plugin dropped events while recording, have no callback; their dropped events
+ * are summed up and reported.
+ * The callbacks are called back to back from one thread, or paced with --rate, and each call is timed. The fake host
+ * (fakehost.h) answers the getters of the plugin from the channels and clients the trace has created so far.
+ * At the end the time the event worker needed to drain its queue is reported; the plugin logs a warning on queue
+ * overflows, printed by the fake host, which marks the rate at which it saturates.
+ *
+ * Linux only, build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/plugin.cpp ../src/infoformat.cpp ../src/profiles.cpp ../src/world.cpp ../src/journal.cpp ../src/talktime.cpp ../src/stringpool.cpp ../src/namecache.cpp ../src/requests.cpp fakehost.cpp replay_events.cpp -o replay_events -lpthread
+ *   ./replay_events restart [clients] [channels] [options]
+ *   ./replay_events churn [clients] [events] [options]
+ *   ./replay_events subscribe [clients] [events] [options]
+ *   ./replay_events journal <segment>... [options]
+ * Options:
+ *   --rate <events per second>  pace the callbacks instead of calling them as fast as possible
+ *   --render <n>                render the info of a client after every n events, timed as infoData
+ *   --save <path>               write the trace as a journal segment, to replay it again later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "teamspeak/public_errors.h"
+#include "teamspeak/public_definitions.h"
+#include "teamspeak/public_rare_definitions.h"
+#include "teamspeak/clientlib_publicdefinitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "journal.h"
+#include "fakehost.h"
+
+#define REPLAY_SCHID 1
+#define REPLAY_DEFAULT_CLIENTS 2000
+#define REPLAY_DEFAULT_CHANNELS 200
+#define REPLAY_DEFAULT_EVENTS 1000000
+#define REPLAY_TALKS_PER_JOIN 4
+#define REPLAY_START_TIME 1700000000000ULL
+#define REPLAY_TEXT_SIZE 1024
+#define REPLAY_INFODATA 0  /* Slot of the infoData timings, not a journal type */
+#define REPLAY_SLOTS (JOURNAL_CHANNEL_UNSUBSCRIBED + 1)
+#define REPLAY_SETTLE_MS 1000  /* Time the client count of the plugin may take to match the fake host */
+
+static const char* const messages[] = { "hi", "brb", "anyone up for a round?", "moving to the music channel" };
+
+/* Tell the fake host what the record changes, so the getters answer like the client would after it */
+static void applyToServer(const struct JournalRecord& record) {
+	const uint64 schid = record.serverConnectionHandlerID;
+	switch (record.type) {
+	case JOURNAL_CONNECTED:
+		fakeHostSetConnected(schid, true);
+		break;
+	case JOURNAL_DISCONNECTED:
+		fakeHostSetConnected(schid, false);
+		break;
+	case JOURNAL_CLIENT_MOVED:
+	case JOURNAL_CLIENT_SUBSCRIPTION:
+	case JOURNAL_CLIENT_KICKED_CHANNEL:
+		fakeHostPlaceClient(schid, (anyID)record.clientID, record.channelID);
+		break;
+	case JOURNAL_CLIENT_TIMEOUT:
+	case JOURNAL_CLIENT_KICKED_SERVER:
+	case JOURNAL_CLIENT_BANNED:
+		fakeHostPlaceClient(schid, (anyID)record.clientID, 0);
+		break;
+	case JOURNAL_CHANNEL_CREATED:
+	case JOURNAL_CHANNEL_MOVED:
+		fakeHostPlaceChannel(schid, record.channelID, record.otherChannelID);
+		break;
+	case JOURNAL_CHANNEL_DELETED:
+		fakeHostRemoveChannel(schid, record.channelID);
+		break;
+	}
+}
+
+/*
+ * Traces
+ */
+static unsigned long nextRandom(unsigned long* random) {
+	*random = *random * 6364136223846793005UL + 1442695040888963407UL;
+	return *random >> 33;
+}
+
+static struct JournalRecord newRecord(const std::vector<struct JournalRecord>& trace, unsigned int type) {
+	struct JournalRecord record;
+	memset(&record, 0, sizeof(record));
+	record.type = type;
+	record.time = REPLAY_START_TIME + trace.size();
+	record.serverConnectionHandlerID = REPLAY_SCHID;
+	return record;
+}
+
+/* Channel list of a tree with FAKEHOST_ROOT_CHANNELS top level channels, listed parents first */
+static void listChannels(std::vector<struct JournalRecord>* trace, unsigned long channels, unsigned long* random) {
+	for (unsigned long i = 1; i <= channels; ++i) {
+		struct JournalRecord record = newRecord(*trace, JOURNAL_CHANNEL_CREATED);
+		record.channelID = i;
+		record.otherChannelID = i <= FAKEHOST_ROOT_CHANNELS ? 0 : 1 + nextRandom(random) % (i - 1);
+		trace->push_back(record);
+	}
+}
+
+static void generateRestart(std::vector<struct JournalRecord>* trace, unsigned long clients, unsigned long channels) {
+	unsigned long random = 1;
+	trace->push_back(newRecord(*trace, JOURNAL_CONNECTED));
+	listChannels(trace, channels, &random);
+	for (unsigned long i = 0; i < clients; ++i) {
+		struct JournalRecord record = newRecord(*trace, JOURNAL_CLIENT_MOVED);
+		record.clientID = 2 + i;
+		record.channelID = 1 + nextRandom(&random) % channels;
+		trace->push_back(record);
+		record = newRecord(*trace, JOURNAL_CLIENT_UPDATED);
+		record.clientID = 2 + i;
+		trace->push_back(record);
+		/* Talking starts while others are still joining */
+		for (int t = 0; t < REPLAY_TALKS_PER_JOIN; ++t) {
+			record = newRecord(*trace, JOURNAL_TALK_STATUS);
+			record.clientID = 2 + nextRandom(&random) % (i + 1);
+			record.value = t % 2 == 0 ? STATUS_TALKING : STATUS_NOT_TALKING;
+			trace->push_back(record);
+		}
+	}
+}
+
+static void generateChurn(std::vector<struct JournalRecord>* trace, unsigned long clients, unsigned long events) {
+	unsigned long random = 1;
+	const unsigned long channels = clients / 10 > FAKEHOST_ROOT_CHANNELS ? clients / 10 : FAKEHOST_ROOT_CHANNELS;
+	std::vector<uint64> channelOf(clients);
+	trace->push_back(newRecord(*trace, JOURNAL_CONNECTED));
+	listChannels(trace, channels, &random);
+	for (unsigned long i = 0; i < clients; ++i) {
+		struct JournalRecord record = newRecord(*trace, JOURNAL_CLIENT_MOVED);
+		record.clientID = 2 + i;
+		record.channelID = channelOf[i] = 1 + nextRandom(&random) % channels;
+		trace->push_back(record);
+	}
+
+	while (trace->size() < events) {
+		const unsigned long r = nextRandom(&random);
+		const unsigned long client = r % clients;
+		struct JournalRecord record = newRecord(*trace, JOURNAL_TALK_STATUS);
+		record.clientID = 2 + client;
+		switch (r % 20) {
+		case 12: case 13: case 14: case 15:
+			record.type = JOURNAL_CLIENT_MOVED;
+			record.otherChannelID = channelOf[client];
+			record.channelID = channelOf[client] = 1 + (r >> 8) % channels;  /* Rejoins if it had left */
+			break;
+		case 16: case 17:
+			record.type = JOURNAL_CLIENT_UPDATED;
+			break;
+		case 18:
+			record.type = JOURNAL_TEXT_MESSAGE;
+			record.value = TextMessageTarget_CHANNEL;
+			record.invokerID = 2 + client;
+			record.clientID = 0;
+			record.text = messages[(r >> 8) % 4];
+			record.textLength = strlen(record.text);
+			break;
+		case 19:
+			if (channelOf[client] == 0) {
+				continue;
+			}
+			record.type = JOURNAL_CLIENT_MOVED;
+			record.otherChannelID = channelOf[client];
+			channelOf[client] = 0;  /* Leaves, a later move brings it back */
+			break;
+		default:
+			if (channelOf[client] == 0) {
+				continue;
+			}
+			record.value = (r >> 8) % 2 ? STATUS_TALKING : STATUS_NOT_TALKING;
+			break;
+		}
+		trace->push_back(record);
+	}
+}
+
+/* Half of the channels subscribed on connect, one is toggled in every tenth event */
+static void generateSubscribe(std::vector<struct JournalRecord>* trace, unsigned long clients, unsigned long events) {
+	unsigned long random = 1;
+	const unsigned long channels = clients / 10 > FAKEHOST_ROOT_CHANNELS ? clients / 10 : FAKEHOST_ROOT_CHANNELS;
+	std::vector<uint64> channelOf(clients);
+	std::vector<std::vector<anyID> > members(channels + 1);
+	std::vector<bool> subscribed(channels + 1);
+	trace->push_back(newRecord(*trace, JOURNAL_CONNECTED));
+	listChannels(trace, channels, &random);
+	for (unsigned long i = 0; i < clients; ++i) {
+		channelOf[i] = 1 + nextRandom(&random) % channels;
+		members[channelOf[i]].push_back((anyID)(2 + i));
+	}
+	for (unsigned long channel = 1; channel <= channels; ++channel) {
+		subscribed[channel] = channel % 2 == 1;
+		for (size_t m = 0; subscribed[channel] && m < members[channel].size(); ++m) {
+			struct JournalRecord record = newRecord(*trace, JOURNAL_CLIENT_MOVED);
+			record.clientID = members[channel][m];
+			record.channelID = channel;
+			trace->push_back(record);
+		}
+	}
+
+	while (trace->size() < events) {
+		const unsigned long r = nextRandom(&random);
+		if (r % 10 != 0) {
+			const unsigned long client = (r >> 4) % clients;
+			if (!subscribed[channelOf[client]]) {
+				continue;
+			}
+			struct JournalRecord record = newRecord(*trace, JOURNAL_TALK_STATUS);
+			record.clientID = 2 + client;
+			record.value = (r >> 8) % 2 ? STATUS_TALKING : STATUS_NOT_TALKING;
+			trace->push_back(record);
+			continue;
+		}
+		/* Like the client: subscribed before its clients come into view, unsubscribed after they went out of it */
+		const uint64 channel = 1 + (r >> 4) % channels;
+		subscribed[channel] = !subscribed[channel];
+		struct JournalRecord record = newRecord(*trace, JOURNAL_CHANNEL_SUBSCRIBED);
+		record.channelID = channel;
+		if (subscribed[channel]) {
+			trace->push_back(record);
+		}
+		for (size_t m = 0; m < members[channel].size(); ++m) {
+			struct JournalRecord move = newRecord(*trace, JOURNAL_CLIENT_SUBSCRIPTION);
+			move.clientID = members[channel][m];
+			move.channelID = subscribed[channel] ? channel : 0;
+			move.otherChannelID = subscribed[channel] ? 0 : channel;
+			trace->push_back(move);
+		}
+		if (!subscribed[channel]) {
+			record.type = JOURNAL_CHANNEL_UNSUBSCRIBED;
+			record.time = REPLAY_START_TIME + trace->size();
+			trace->push_back(record);
+		}
+	}
+}
+
+/* Journal segments stay mapped while replaying, the texts point into them */
+static bool loadJournal(std::vector<struct JournalRecord>* trace, std::vector<std::unique_ptr<JournalReader> >* readers, const char* path) {
+	std::unique_ptr<JournalReader> reader(new JournalReader());
+	if (!reader->open(path)) {
+		fprintf(stderr, "%s is no journal\n", path);
+		return false;
+	}
+	struct JournalRecord record;
+	while (reader->next(&record)) {
+		trace->push_back(record);
+	}
+	readers->push_back(std::move(reader));
+	return true;
+}
+
+/*
+ * Replaying
+ */
+static char text[REPLAY_TEXT_SIZE];
+
+static const char* recordText(const struct JournalRecord& record) {
+	const size_t length = record.textLength < REPLAY_TEXT_SIZE ? record.textLength : REPLAY_TEXT_SIZE - 1;
+	if (length > 0) {  /* Records without a text have none to copy from */
+		memcpy(text, record.text, length);
+	}
+	text[length] = '\0';
+	return text;
+}
+
+/* Call the callback the client would call for the record */
+static void deliver(const struct JournalRecord& record, const char* message) {
+	const uint64 schid = record.serverConnectionHandlerID;
+	const anyID client = (anyID)record.clientID;
+	const anyID invoker = (anyID)record.invokerID;
+	switch (record.type) {
+	case JOURNAL_CONNECTED:
+		ts3plugin_onConnectStatusChangeEvent(schid, STATUS_CONNECTION_ESTABLISHED, ERROR_ok);
+		break;
+	case JOURNAL_DISCONNECTED:
+		ts3plugin_onConnectStatusChangeEvent(schid, STATUS_DISCONNECTED, (unsigned int)record.value);
+		break;
+	case JOURNAL_CLIENT_MOVED: {
+		const int visibility = record.otherChannelID == 0 ? ENTER_VISIBILITY : record.channelID == 0 ? LEAVE_VISIBILITY : RETAIN_VISIBILITY;
+		if (invoker) {
+			ts3plugin_onClientMoveMovedEvent(schid, client, record.otherChannelID, record.channelID, visibility, invoker, "", "", message);
+		}
+		else {
+			ts3plugin_onClientMoveEvent(schid, client, record.otherChannelID, record.channelID, visibility, message);
+		}
+		break;
+	}
+	case JOURNAL_CLIENT_SUBSCRIPTION:
+		ts3plugin_onClientMoveSubscriptionEvent(schid, client, record.otherChannelID, record.channelID, record.channelID == 0 ? LEAVE_VISIBILITY : ENTER_VISIBILITY);
+		break;
+	case JOURNAL_CLIENT_TIMEOUT:
+		ts3plugin_onClientMoveTimeoutEvent(schid, client, record.otherChannelID, 0, LEAVE_VISIBILITY, message);
+		break;
+	case JOURNAL_CLIENT_KICKED_CHANNEL:
+		ts3plugin_onClientKickFromChannelEvent(schid, client, record.otherChannelID, record.channelID, RETAIN_VISIBILITY, invoker, "", "", message);
+		break;
+	case JOURNAL_CLIENT_KICKED_SERVER:
+		ts3plugin_onClientKickFromServerEvent(schid, client, record.otherChannelID, 0, LEAVE_VISIBILITY, invoker, "", "", message);
+		break;
+	case JOURNAL_CLIENT_BANNED:
+		ts3plugin_onClientBanFromServerEvent(schid, client, record.otherChannelID, 0, LEAVE_VISIBILITY, invoker, "", "", record.value, message);
+		break;
+	case JOURNAL_TALK_STATUS:
+		ts3plugin_onTalkStatusChangeEvent(schid, (int)record.value, 0, client);
+		break;
+	case JOURNAL_CLIENT_UPDATED:
+		ts3plugin_onUpdateClientEvent(schid, client, invoker, "", "");
+		break;
+	case JOURNAL_CHANNEL_CREATED:
+		if (invoker) {
+			ts3plugin_onNewChannelCreatedEvent(schid, record.channelID, record.otherChannelID, invoker, "", "");
+		}
+		else {  /* Listed on connect */
+			ts3plugin_onNewChannelEvent(schid, record.channelID, record.otherChannelID);
+		}
+		break;
+	case JOURNAL_CHANNEL_DELETED:
+		ts3plugin_onDelChannelEvent(schid, record.channelID, invoker, "", "");
+		break;
+	case JOURNAL_CHANNEL_MOVED:
+		ts3plugin_onChannelMoveEvent(schid, record.channelID, record.otherChannelID, invoker, "", "");
+		break;
+	case JOURNAL_CHANNEL_EDITED:
+		ts3plugin_onUpdateChannelEditedEvent(schid, record.channelID, invoker, "", "");
+		break;
+	case JOURNAL_SERVER_EDITED:
+		ts3plugin_onServerEditedEvent(schid, invoker, "", "");
+		break;
+	case JOURNAL_TEXT_MESSAGE:
+		ts3plugin_onTextMessageEvent(schid, (anyID)record.value, client, invoker, "", "", message, 0);
+		break;
+	case JOURNAL_SERVER_GROUP_ADDED:
+		ts3plugin_onServerGroupClientAddedEvent(schid, client, "", "", record.groupID, invoker, "", "");
+		break;
+	case JOURNAL_SERVER_GROUP_REMOVED:
+		ts3plugin_onServerGroupClientDeletedEvent(schid, client, "", "", record.groupID, invoker, "", "");
+		break;
+	case JOURNAL_CHANNEL_GROUP_CHANGED:
+		ts3plugin_onClientChannelGroupChangedEvent(schid, record.groupID, record.channelID, client, invoker, "", "");
+		break;
+	case JOURNAL_CHANNEL_SUBSCRIBED:
+		ts3plugin_onChannelSubscribeEvent(schid, record.channelID);
+		break;
+	case JOURNAL_CHANNEL_UNSUBSCRIBED:
+		ts3plugin_onChannelUnsubscribeEvent(schid, record.channelID);
+		break;
+	}
+}
+
+static long elapsedNs(std::chrono::steady_clock::time_point start) {
+	return (long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printLatencies(const char* name, std::vector<long>* samples) {
+	if (samples->empty()) {
+		return;
+	}
+	std::sort(samples->begin(), samples->end());
+	const size_t n = samples->size();
+	printf("%-26s %9zu calls  p50 %7ld ns  p99 %7ld ns  p99.9 %8ld ns  max %9ld ns\n",
+	       name, n, (*samples)[n / 2], (*samples)[n * 99 / 100], (*samples)[n * 999 / 1000], (*samples)[n - 1]);
+}
+
+/* Client count shown in the server info once the worker caught up, -1 if there is none */
+static long shownClients(uint64 schid) {
+	const char* const label = "Server Clients = ";
+	long clients = -1;
+	char* data = NULL;
+	fakeHostSync(schid);
+	ts3plugin_infoData(schid, 0, PLUGIN_SERVER, &data);
+	if (data) {
+		const char* field = strstr(data, label);
+		if (field) {
+			clients = atol(field + strlen(label));
+		}
+		ts3plugin_freeMemory(data);
+	}
+	return clients;
+}
+
+/* After an overflow the worker seeds the world again once it applied what was queued, the sync can come before that */
+static long settledClients(uint64 schid, unsigned int inView) {
+	long clients = shownClients(schid);
+	for (int i = 0; i < REPLAY_SETTLE_MS && clients != (long)inView; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		clients = shownClients(schid);
+	}
+	return clients;
+}
+
+static void usage(const char* program) {
+	fprintf(stderr, "usage: %s restart [clients] [channels] [options]\n", program);
+	fprintf(stderr, "       %s churn [clients] [events] [options]\n", program);
+	fprintf(stderr, "       %s subscribe [clients] [events] [options]\n", program);
+	fprintf(stderr, "       %s journal <segment>... [options]\n", program);
+	fprintf(stderr, "options: --rate <events per second>  --render <every n events>  --save <path>\n");
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		usage(argv[0]);
+		return 1;
+	}
+	std::vector<const char*> arguments;
+	double rate = 0;
+	long renderInterval = 0;
+	const char* savePath = NULL;
+	bool checkClients = false;
+	for (int i = 2; i < argc; ++i) {
+		if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+			rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+			renderInterval = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+			savePath = argv[++i];
+		}
+		else {
+			arguments.push_back(argv[i]);
+		}
+	}
+
+	std::vector<struct JournalRecord> trace;
+	std::vector<std::unique_ptr<JournalReader> > readers;
+	if (strcmp(argv[1], "restart") == 0) {
+		const long clients = arguments.size() > 0 ? atol(arguments[0]) : REPLAY_DEFAULT_CLIENTS;
+		const long channels = arguments.size() > 1 ? atol(arguments[1]) : REPLAY_DEFAULT_CHANNELS;
+		if (clients <= 0 || clients > 65000 || channels <= 0) {
+			usage(argv[0]);
+			return 1;
+		}
+		generateRestart(&trace, clients, channels);
+	}
+	else if (strcmp(argv[1], "churn") == 0 || strcmp(argv[1], "subscribe") == 0) {
+		const long clients = arguments.size() > 0 ? atol(arguments[0]) : REPLAY_DEFAULT_CLIENTS;
+		const long events = arguments.size() > 1 ? atol(arguments[1]) : REPLAY_DEFAULT_EVENTS;
+		if (clients <= 0 || clients > 65000 || events <= 0) {
+			usage(argv[0]);
+			return 1;
+		}
+		if (strcmp(argv[1], "churn") == 0) {
+			generateChurn(&trace, clients, events);
+		}
+		else {
+			generateSubscribe(&trace, clients, events);
+			checkClients = true;
+		}
+	}
+	else if (strcmp(argv[1], "journal") == 0 && !arguments.empty()) {
+		for (size_t i = 0; i < arguments.size(); ++i) {
+			if (!loadJournal(&trace, &readers, arguments[i])) {
+				return 1;
+			}
+		}
+	}
+	else {
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (savePath) {
+		JournalWriter writer;
+		remove(savePath);  /* The writer would continue an existing journal */
+		if (!writer.open(savePath, (size_t)-1, 1, 64 * 1024)) {
+			return 1;
+		}
+		for (size_t i = 0; i < trace.size(); ++i) {
+			writer.append(trace[i]);
+		}
+		writer.close();
+		printf("trace saved to %s\n", savePath);
+	}
+
+	struct FakeHostConfig config;
+	memset(&config, 0, sizeof(config));  /* The trace creates the servers */
+	ts3plugin_setFunctionPointers(fakeHostSetup(config));
+	if (ts3plugin_init() != 0) {
+		fprintf(stderr, "ts3plugin_init failed\n");
+		return 1;
+	}
+	ts3plugin_registerPluginID("fakehost");
+
+	std::vector<std::vector<long> > latencies(REPLAY_SLOTS);
+	std::vector<unsigned long> counts(REPLAY_SLOTS);
+	for (size_t i = 0; i < trace.size(); ++i) {
+		++counts[trace[i].type < REPLAY_SLOTS ? trace[i].type : REPLAY_INFODATA];
+	}
+	for (size_t type = 1; type < REPLAY_SLOTS; ++type) {
+		latencies[type].reserve(counts[type]);
+	}
+	latencies[REPLAY_INFODATA].reserve(renderInterval > 0 ? trace.size() / renderInterval + 1 : 0);
+
+	printf("replaying %zu events%s\n", trace.size(), rate > 0 ? ", paced" : " as fast as possible");
+	unsigned long random = 1;
+	unsigned long gaps = 0;
+	unsigned long long lostEvents = 0;
+	const std::chrono::nanoseconds interval(rate > 0 ? (long long)(1e9 / rate) : 0);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point next = start;
+	for (size_t i = 0; i < trace.size(); ++i) {
+		const struct JournalRecord& record = trace[i];
+		if (record.type == JOURNAL_EVENTS_DROPPED) {
+			++gaps;
+			lostEvents += record.value;
+			continue;
+		}
+		if (record.type == 0 || record.type >= REPLAY_SLOTS) {
+			continue;
+		}
+		if (record.type != JOURNAL_CONNECTED && record.type != JOURNAL_DISCONNECTED && !fakeHostConnected(record.serverConnectionHandlerID)) {
+			/* Recorded without its connect */
+			struct JournalRecord connect = record;
+			connect.type = JOURNAL_CONNECTED;
+			applyToServer(connect);
+			deliver(connect, "");
+		}
+		applyToServer(record);
+		const char* message = recordText(record);
+		if (rate > 0) {
+			while (std::chrono::steady_clock::now() < next) {
+			}
+			next += interval;
+		}
+
+		const std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+		deliver(record, message);
+		latencies[record.type].push_back(elapsedNs(before));
+
+		if (renderInterval > 0 && (long)(i + 1) % renderInterval == 0) {
+			const anyID client = fakeHostAnyClient(record.serverConnectionHandlerID, nextRandom(&random));
+			if (client) {
+				char* data = NULL;
+				const std::chrono::steady_clock::time_point renderStart = std::chrono::steady_clock::now();
+				ts3plugin_infoData(record.serverConnectionHandlerID, client, PLUGIN_CLIENT, &data);
+				latencies[REPLAY_INFODATA].push_back(elapsedNs(renderStart));
+				if (data) {
+					ts3plugin_freeMemory(data);
+				}
+			}
+		}
+	}
+	const double replaySeconds = elapsedNs(start) / 1e9;
+	const unsigned int inView = fakeHostClientCount(REPLAY_SCHID);
+	const long shown = checkClients ? settledClients(REPLAY_SCHID, inView) : -1;
+
+	/* Shutting down applies what is still queued before joining the worker */
+	const std::chrono::steady_clock::time_point drainStart = std::chrono::steady_clock::now();
+	ts3plugin_shutdown();
+	const double drainSeconds = elapsedNs(drainStart) / 1e9;
+
+	for (size_t type = 1; type < REPLAY_SLOTS; ++type) {
+		printLatencies(journalTypeName((unsigned int)type), &latencies[type]);
+	}
+	printLatencies("infoData", &latencies[REPLAY_INFODATA]);
+	printf("%zu events in %.3f s: %.0f events/s delivered, worker drained its queue %.3f s after the last one\n",
+	       trace.size(), replaySeconds, trace.size() / replaySeconds, drainSeconds);
+	if (gaps > 0) {
+		printf("%llu events missing from the trace, dropped by the plugin while recording at %lu gaps\n", lostEvents, gaps);
+	}
+	if (checkClients) {
+		printf("server info shows %ld clients, %u in view\n", shown, inView);
+		return shown == (long)inView ? 0 : 1;
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * Soak benchmark for ts3plugin_infoData
+ *
+ * Renders the server, channel and client info of a small fake host server (fakehost.h) over and over and reports
+ * how the resident set size and the number of strings handed out by the "client library" develop. The client is
+ * updated before every render, so each iteration goes through the client library getters instead of the property
+ * cache. As the plugin applies events on its worker thread, every iteration waits until the worker has handled the
+ * update. The requests of the plugin are answered after the renders.
+ * The away message of the client and the phonetic name of the channel change with every iteration, like texts users
+ * edit all the time; the plugin must free the old ones instead of keeping every value it ever saw.
+ * Every SOAK_RECONNECT_INTERVAL iterations the connection drops and comes back, which must free and rebuild its shard.
+ * Exits with 1 if library buffers are never released or the resident set grew by more than SOAK_MAX_GROWTH_KIB.
+ *
+ * Linux only, build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/plugin.cpp ../src/infoformat.cpp ../src/profiles.cpp ../src/world.cpp ../src/journal.cpp ../src/talktime.cpp ../src/stringpool.cpp ../src/namecache.cpp ../src/requests.cpp fakehost.cpp soak_infodata.cpp -o soak_infodata -lpthread
+ *   ./soak_infodata [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include "teamspeak/public_errors.h"
+#include "teamspeak/public_definitions.h"
+#include "teamspeak/public_rare_definitions.h"
+#include "teamspeak/clientlib_publicdefinitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "fakehost.h"
+
+#define SOAK_SCHID 1
+#define SOAK_CHANNELS 10
+#define SOAK_CLIENTS 5
+#define SOAK_CHANNEL SOAK_CHANNELS
+#define SOAK_CLIENT SOAK_CLIENTS
+#define SOAK_DEFAULT_ITERATIONS 1000000
+#define SOAK_RECONNECT_INTERVAL 10000
+#define SOAK_MAX_GROWTH_KIB 1024  /* Allocator noise; keeping every changing text grew by some 48 KiB per 1000 renders */
+
+/* Resident set size in KiB */
+static long residentKiB() {
+	long pages = 0, resident = 0;
+	FILE* statm = fopen("/proc/self/statm", "r");
+	if (!statm) {
+		return -1;
+	}
+	if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(statm);
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* Post a client update and wait until the worker applied it */
+static void updateClient() {
+	fakeHostUpdateClient(SOAK_SCHID, SOAK_CLIENT);
+	fakeHostSync(SOAK_SCHID);
+}
+
+static void render(enum PluginItemType type, uint64 id) {
+	char* data = NULL;
+	ts3plugin_infoData(SOAK_SCHID, id, type, &data);
+	if (data) {
+		ts3plugin_freeMemory(data);
+	}
+}
+
+int main(int argc, char** argv) {
+	const long iterations = argc > 1 ? atol(argv[1]) : SOAK_DEFAULT_ITERATIONS;
+
+	struct FakeHostConfig config;
+	config.servers = 1;
+	config.channels = SOAK_CHANNELS;
+	config.clients = SOAK_CLIENTS;
+	config.latencyNs = 0;
+	config.connected = false;
+	config.configPath = NULL;
+	const struct TS3Functions funcs = fakeHostSetup(config);
+	ts3plugin_setFunctionPointers(funcs);
+	if (ts3plugin_init() != 0) {
+		fprintf(stderr, "ts3plugin_init failed\n");
+		return 1;
+	}
+	ts3plugin_registerPluginID("fakehost");
+	fakeHostConnect(SOAK_SCHID);
+
+	/* Warm up allocator and caches before taking the baseline */
+	for (int i = 0; i < 1000; ++i) {
+		updateClient();
+		render(PLUGIN_CLIENT, SOAK_CLIENT);
+	}
+	const long baseline = residentKiB();
+
+	for (long i = 1; i <= iterations; ++i) {
+		const std::string text = "changing text " + std::to_string(i);
+		fakeHostSetClientText(SOAK_SCHID, SOAK_CLIENT, CLIENT_AWAY_MESSAGE, text.c_str());
+		fakeHostSetChannelText(SOAK_SCHID, SOAK_CHANNEL, CHANNEL_NAME_PHONETIC, text.c_str());
+		fakeHostUpdateChannel(SOAK_SCHID, SOAK_CHANNEL);
+		fakeHostUpdateServer(SOAK_SCHID);
+		updateClient();
+		render(PLUGIN_SERVER, 0);
+		render(PLUGIN_CHANNEL, SOAK_CHANNEL);
+		render(PLUGIN_CLIENT, SOAK_CLIENT);
+		fakeHostAnswerRequests();
+		if (i % SOAK_RECONNECT_INTERVAL == 0) {
+			fakeHostDisconnect(SOAK_SCHID);
+			fakeHostConnect(SOAK_SCHID);
+		}
+
+		if (i % (iterations / 10 ? iterations / 10 : 1) == 0) {
+			printf("%10ld renders  rss %8ld KiB  growth %+8ld KiB  unreleased library buffers %lld\n",
+			       i, residentKiB(), residentKiB() - baseline, fakeHostOutstanding());
+		}
+	}
+
+	ts3plugin_shutdown();
+
+	const long growth = residentKiB() - baseline;
+	printf("rss growth %+ld KiB over %ld renders, %lld library buffers never released\n", growth, iterations, fakeHostOutstanding());
+	if (growth > SOAK_MAX_GROWTH_KIB) {
+		printf("FAILED: memory grew by more than %d KiB\n", SOAK_MAX_GROWTH_KIB);
+	}
+	return fakeHostOutstanding() == 0 && growth <= SOAK_MAX_GROWTH_KIB ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+/*
+ * Checks of ts3plugin_infoData against a fake host server (fakehost.h)
+ *
+ * Values longer than the info data buffer, like long away messages and channel descriptions, must be rendered
+ * completely up to the largest buffer and cut with a marker at a character boundary beyond it. Connections established
+ * before the plugin was loaded must get their world seeded without waiting for an event. Prints every failed check and
+ * exits with 1 if there was one.
+ *
+ * Linux only, build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/plugin.cpp ../src/infoformat.cpp ../src/profiles.cpp ../src/world.cpp ../src/journal.cpp ../src/talktime.cpp ../src/stringpool.cpp ../src/namecache.cpp ../src/requests.cpp fakehost.cpp test_infodata.cpp -o test_infodata -lpthread
+ *   ./test_infodata
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "teamspeak/public_errors.h"
+#include "teamspeak/public_definitions.h"
+#include "teamspeak/public_rare_definitions.h"
+#include "teamspeak/clientlib_publicdefinitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "fakehost.h"
+
+#define TEST_SCHID 1
+#define TEST_CHANNELS 10
+#define TEST_CLIENTS 5
+#define TEST_CHANNEL TEST_CHANNELS
+#define TEST_CLIENT TEST_CLIENTS
+#define TEST_LONG_LENGTH 20000      /* Beyond INFODATA_BUFSIZE of the plugin */
+#define TEST_HUGE_LENGTH 1000000    /* Beyond INFODATA_MAX_BUFSIZE */
+#define CUT_MARKER "..."
+
+static unsigned int failures = 0;
+
+static void check(bool passed, const char* what) {
+	if (!passed) {
+		printf("FAILED: %s\n", what);
+		++failures;
+	}
+}
+
+static std::string render(enum PluginItemType type, uint64 id) {
+	char* data = NULL;
+	ts3plugin_infoData(TEST_SCHID, id, type, &data);
+	std::string text = data ? data : "";
+	if (data) {
+		ts3plugin_freeMemory(data);
+	}
+	return text;
+}
+
+/* Value of the line "label = value" in text, empty if there is none */
+static std::string fieldValue(const std::string& text, const char* label) {
+	const std::string start = std::string(label) + " = ";
+	size_t position = text.compare(0, start.length(), start) == 0 ? 0 : text.find("\n" + start);
+	if (position == std::string::npos) {
+		return std::string();
+	}
+	position += position == 0 ? start.length() : start.length() + 1;
+	const size_t end = text.find('\n', position);
+	return text.substr(position, end == std::string::npos ? std::string::npos : end - position);
+}
+
+static void setAwayMessage(const std::string& message) {
+	fakeHostSetClientText(TEST_SCHID, TEST_CLIENT, CLIENT_AWAY_MESSAGE, message.c_str());
+	fakeHostUpdateClient(TEST_SCHID, TEST_CLIENT);
+	fakeHostSync(TEST_SCHID);
+}
+
+static bool endsWith(const std::string& text, const std::string& end) {
+	return text.length() >= end.length() && text.compare(text.length() - end.length(), end.length(), end) == 0;
+}
+
+/* Load the plugin with the test server connected before or connected afterwards */
+static bool load(bool connected) {
+	struct FakeHostConfig config;
+	config.servers = 1;
+	config.channels = TEST_CHANNELS;
+	config.clients = TEST_CLIENTS;
+	config.latencyNs = 0;
+	config.connected = connected;
+	config.configPath = NULL;
+	ts3plugin_setFunctionPointers(fakeHostSetup(config));
+	if (ts3plugin_init() != 0) {
+		fprintf(stderr, "ts3plugin_init failed\n");
+		return false;
+	}
+	ts3plugin_registerPluginID("fakehost");
+	if (!connected) {
+		fakeHostConnect(TEST_SCHID);
+	}
+	fakeHostSync(TEST_SCHID);
+	return true;
+}
+
+static void unload() {
+	ts3plugin_shutdown();
+	if (fakeHostOutstanding() != 0) {
+		printf("FAILED: %lld library buffers never released\n", fakeHostOutstanding());
+		++failures;
+	}
+}
+
+int main() {
+	if (!load(false)) {
+		return 1;
+	}
+
+	/* A long away message is shown completely and the fields after it are kept */
+	const std::string longMessage(TEST_LONG_LENGTH, 'a');
+	setAwayMessage(longMessage);
+	std::string text = render(PLUGIN_CLIENT, TEST_CLIENT);
+	check(fieldValue(text, "CLIENT_AWAY_MESSAGE") == longMessage, "long away message shown completely");
+	check(!fieldValue(text, "CLIENT_TYPE").empty(), "fields after a long away message kept");
+	check(render(PLUGIN_CLIENT, TEST_CLIENT) == text, "long text handed out again from the cache");
+
+	/* So is a long channel value */
+	const std::string longName(TEST_LONG_LENGTH, 'c');
+	fakeHostSetChannelText(TEST_SCHID, TEST_CHANNEL, CHANNEL_NAME_PHONETIC, longName.c_str());
+	fakeHostUpdateChannel(TEST_SCHID, TEST_CHANNEL);
+	fakeHostSync(TEST_SCHID);
+	text = render(PLUGIN_CHANNEL, TEST_CHANNEL);
+	check(fieldValue(text, "Phoetic Channelname") == longName, "long channel name shown completely");
+	check(!fieldValue(text, "CHANNEL_FLAG_PRIVATE").empty(), "fields after a long channel name kept");
+
+	/* A huge one is cut with the marker, between two characters of two bytes each */
+	std::string hugeMessage;
+	while (hugeMessage.length() < TEST_HUGE_LENGTH) {
+		hugeMessage += "\xC3\xA4";
+	}
+	setAwayMessage("x" + hugeMessage);
+	text = render(PLUGIN_CLIENT, TEST_CLIENT);
+	const std::string cut = fieldValue(text, "CLIENT_AWAY_MESSAGE");
+	check(endsWith(cut, CUT_MARKER), "huge away message marked as cut");
+	check(cut.length() > TEST_LONG_LENGTH && cut.length() < TEST_HUGE_LENGTH, "huge away message cut to the largest buffer");
+	check(cut.length() >= 1 + strlen(CUT_MARKER) && (cut.length() - 1 - strlen(CUT_MARKER)) % 2 == 0, "huge away message cut at a character boundary");
+	check(fieldValue(text, "CLIENT_TYPE").empty(), "fields after the cut dropped");
+	check(text.compare(0, 12, "Client ID = ") == 0, "fields before the cut kept");
+
+	/* Back to a short one */
+	setAwayMessage("back soon");
+	text = render(PLUGIN_CLIENT, TEST_CLIENT);
+	check(fieldValue(text, "CLIENT_AWAY_MESSAGE") == "back soon", "short away message after a cut one");
+	unload();
+
+	/* The worker seeds the world of a connection established before loading, no event needed */
+	if (!load(true)) {
+		return 1;
+	}
+	text = render(PLUGIN_SERVER, 0);
+	const std::string clients = std::to_string(TEST_CLIENTS) + " (";
+	check(fieldValue(text, "Server Clients").compare(0, clients.length(), clients) == 0, "established connection seeded");
+	text = fieldValue(render(PLUGIN_CHANNEL, 1), "Clients");
+	check(!text.empty() && text != "unavailable", "channel of an established connection counted");
+	unload();
+
+	printf("%u failed checks\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/*
+ * Checks of JournalWriter and JournalReader (journal.h)
+ *
+ * Restarting the plugin must continue the current segment instead of rotating, so the history survives any number of
+ * restarts; segments rotate at their size limit only, or when the current one ends in a damaged record. Cut texts keep
+ * their flag, gap records their count of dropped events. Prints every failed check and exits with 1 if there was one.
+ *
+ * Build from this directory:
+ *   g++ -std=c++17 -O2 -I../include -I../src ../src/journal.cpp test_journal.cpp -o test_journal
+ *   ./test_journal [directory]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "journal.h"
+
+#define TEST_SEGMENT_SIZE 4096
+#define TEST_SEGMENTS 8
+#define TEST_BUFFER_SIZE 256
+#define TEST_RESTARTS (2 * TEST_SEGMENTS)
+#define TEST_START_TIME 1700000000000ULL
+
+static unsigned int failures = 0;
+static std::string path;
+
+static void check(bool passed, const char* what) {
+	if (!passed) {
+		printf("FAILED: %s\n", what);
+		++failures;
+	}
+}
+
+static std::string segmentPath(unsigned int segment) {
+	return segment == 0 ? path : path + "." + std::to_string(segment);
+}
+
+static void removeSegments() {
+	for (unsigned int i = 0; i < TEST_SEGMENTS; ++i) {
+		remove(segmentPath(i).c_str());
+	}
+}
+
+static struct JournalRecord makeRecord(uint64 time, const char* text, bool truncated) {
+	struct JournalRecord record;
+	memset(&record, 0, sizeof(record));
+	record.type = JOURNAL_TEXT_MESSAGE;
+	record.time = time;
+	record.serverConnectionHandlerID = 1;
+	record.clientID = 2;
+	record.text = text;
+	record.textLength = strlen(text);
+	record.textTruncated = truncated;
+	return record;
+}
+
+/* Records of a segment, -1 if it cannot be read */
+static long countRecords(unsigned int segment, std::vector<uint64>* times) {
+	JournalReader reader;
+	if (!reader.open(segmentPath(segment).c_str())) {
+		return -1;
+	}
+	struct JournalRecord record;
+	long count = 0;
+	while (reader.next(&record)) {
+		if (times) {
+			times->push_back(record.time);
+		}
+		++count;
+	}
+	return count;
+}
+
+static bool fileExists(const std::string& name) {
+	FILE* file = fopen(name.c_str(), "rb");
+	if (file) {
+		fclose(file);
+	}
+	return file != NULL;
+}
+
+int main(int argc, char** argv) {
+	path = std::string(argc > 1 ? argv[1] : ".") + "/test.journal";
+	removeSegments();
+
+	/* One record per session: every restart continues the segment, the times stay in order */
+	for (unsigned int i = 0; i < TEST_RESTARTS; ++i) {
+		JournalWriter writer;
+		if (!writer.open(path.c_str(), TEST_SEGMENT_SIZE, TEST_SEGMENTS, TEST_BUFFER_SIZE)) {
+			printf("FAILED: journal cannot be opened\n");
+			return 1;
+		}
+		writer.append(makeRecord(TEST_START_TIME + i * 1000, "hi", false));
+		writer.close();
+	}
+	std::vector<uint64> times;
+	check(countRecords(0, &times) == TEST_RESTARTS, "records of every session kept in the current segment");
+	check(!fileExists(segmentPath(1)), "no rotation on restart");
+	bool ordered = times.size() == TEST_RESTARTS;
+	for (size_t i = 0; ordered && i < times.size(); ++i) {
+		ordered = times[i] == TEST_START_TIME + i * 1000;
+	}
+	check(ordered, "times decoded across sessions");
+
+	/* Cut texts keep their flag */
+	{
+		JournalWriter writer;
+		writer.open(path.c_str(), TEST_SEGMENT_SIZE, TEST_SEGMENTS, TEST_BUFFER_SIZE);
+		writer.append(makeRecord(TEST_START_TIME + TEST_RESTARTS * 1000, "the start of a long", true));
+		writer.close();
+		JournalReader reader;
+		struct JournalRecord record;
+		bool truncated = false;
+		unsigned int flagged = 0;
+		reader.open(path.c_str());
+		while (reader.next(&record)) {
+			truncated = record.textTruncated;
+			flagged += record.textTruncated ? 1 : 0;
+		}
+		check(truncated && flagged == 1, "cut text flagged, whole ones not");
+	}
+
+	/* Gaps keep their time and the number of dropped events */
+	{
+		struct JournalRecord gap;
+		memset(&gap, 0, sizeof(gap));
+		gap.type = JOURNAL_EVENTS_DROPPED;
+		gap.time = TEST_START_TIME + TEST_RESTARTS * 1000 + 1;
+		gap.serverConnectionHandlerID = 1;
+		gap.value = 8131;
+		gap.text = "";
+		JournalWriter writer;
+		writer.open(path.c_str(), TEST_SEGMENT_SIZE, TEST_SEGMENTS, TEST_BUFFER_SIZE);
+		writer.append(gap);
+		writer.close();
+		JournalReader reader;
+		struct JournalRecord record;
+		struct JournalRecord last;
+		memset(&last, 0, sizeof(last));
+		reader.open(path.c_str());
+		while (reader.next(&record)) {
+			last = record;
+		}
+		check(last.type == JOURNAL_EVENTS_DROPPED && last.time == gap.time && last.value == gap.value && last.clientID == 0,
+		      "gap record decoded with its time and count");
+		check(strcmp(journalTypeName(JOURNAL_EVENTS_DROPPED), "events dropped") == 0, "gap record named");
+	}
+
+	/* Filling the segment rotates it, at the size limit only */
+	{
+		JournalWriter writer;
+		writer.open(path.c_str(), TEST_SEGMENT_SIZE, TEST_SEGMENTS, TEST_BUFFER_SIZE);
+		for (unsigned int i = 0; i < TEST_SEGMENT_SIZE / 8; ++i) {
+			writer.append(makeRecord(TEST_START_TIME + TEST_RESTARTS * 1000 + i, "hi", false));
+		}
+		writer.close();
+	}
+	check(countRecords(1, NULL) > TEST_RESTARTS, "full segment rotated with the earlier sessions in it");
+	check(countRecords(0, NULL) > 0 && !fileExists(segmentPath(2)), "one rotation for one full segment");
+
+	/* A damaged record at the end is not appended to */
+	const long before = countRecords(0, NULL);
+	FILE* file = fopen(path.c_str(), "ab");
+	fputc(0x7F, file);  /* Length of a record that never follows */
+	fclose(file);
+	{
+		JournalWriter writer;
+		writer.open(path.c_str(), TEST_SEGMENT_SIZE, TEST_SEGMENTS, TEST_BUFFER_SIZE);
+		writer.append(makeRecord(TEST_START_TIME + TEST_SEGMENT_SIZE * 1000, "after the crash", false));
+		writer.close();
+	}
+	check(countRecords(1, NULL) == before && countRecords(0, NULL) == 1, "damaged segment rotated, new records readable");
+	check(fileExists(segmentPath(2)), "earlier segments kept on rotation");
+
+	removeSegments();
+	printf("%u failed checks\n", failures);
+	return failures == 0 ? 0 : 1;
+}
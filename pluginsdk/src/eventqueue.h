@@ -0,0 +1,96 @@
+/*
+ * Bounded lock-free queue handing events from the client threads to the plugin worker
+ */
+
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+#define EVENTQUEUE_CACHE_LINE 64
+
+/*
+ * Multi producer, single consumer ring of fixed size records. Every slot carries a sequence number telling whether it
+ * is free for the producer claiming position n (sequence n) or holds the record written at position n (sequence n + 1),
+ * so producers only race on the shared write position and never wait for each other or the consumer. push fails
+ * instead of blocking when the ring is full. The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class EventQueue {
+public:
+	explicit EventQueue(size_t capacity) : slots(roundUp(capacity)), writePosition(0), readPosition(0) {
+		for (size_t i = 0; i < slots.size(); ++i) {
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	EventQueue(const EventQueue&) = delete;
+	EventQueue& operator=(const EventQueue&) = delete;
+
+	size_t capacity() const { return slots.size(); }
+
+	/* Copy record into the queue, returns false if the queue is full. Any thread. */
+	bool push(const T& record) {
+		const size_t mask = slots.size() - 1;
+		size_t position = writePosition.load(std::memory_order_relaxed);
+		struct Slot* slot;
+		for (;;) {
+			slot = &slots[position & mask];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const ptrdiff_t distance = (ptrdiff_t)(sequence - position);
+			if (distance == 0) {
+				if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (distance < 0) {
+				return false;  /* The consumer did not free this slot yet */
+			}
+			else {
+				position = writePosition.load(std::memory_order_relaxed);
+			}
+		}
+		slot->record = record;
+		slot->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Take the oldest record, returns false if the queue is empty. Consumer thread only. */
+	bool pop(T* record) {
+		struct Slot* slot = &slots[readPosition & (slots.size() - 1)];
+		if (slot->sequence.load(std::memory_order_acquire) != readPosition + 1) {
+			return false;
+		}
+		*record = slot->record;
+		slot->sequence.store(readPosition + slots.size(), std::memory_order_release);
+		++readPosition;
+		return true;
+	}
+
+	/* Consumer thread only */
+	bool empty() const {
+		return slots[readPosition & (slots.size() - 1)].sequence.load(std::memory_order_acquire) != readPosition + 1;
+	}
+
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		T record;
+	};
+
+	static size_t roundUp(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity) {
+			size *= 2;
+		}
+		return size;
+	}
+
+	std::vector<struct Slot> slots;
+	alignas(EVENTQUEUE_CACHE_LINE) std::atomic<size_t> writePosition;
+	alignas(EVENTQUEUE_CACHE_LINE) size_t readPosition;  /* Owned by the consumer */
+};
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Open addressing hash map for channel and client IDs
+ */
+
+#ifndef FLATMAP_H
+#define FLATMAP_H
+
+#include <stddef.h>
+#include <vector>
+
+/*
+ * Hash map from integral IDs to values, stored in one flat array with linear probing. Key 0 marks empty slots, which
+ * suits channel and client IDs as neither uses 0. Erasing shifts the following entries back instead of leaving
+ * tombstones, so lookups stay short after many joins and leaves. Pointers to values are invalidated by insert and
+ * erase.
+ */
+template <typename Key, typename Value>
+class FlatMap {
+public:
+	FlatMap() : count(0) {}
+
+	size_t size() const { return count; }
+
+	Value* find(Key key) {
+		if (key == 0 || slots.empty()) {
+			return NULL;
+		}
+		for (size_t i = slotOf(key); ; i = (i + 1) & mask()) {
+			if (slots[i].key == key) {
+				return &slots[i].value;
+			}
+			if (slots[i].key == 0) {
+				return NULL;
+			}
+		}
+	}
+
+	const Value* find(Key key) const { return const_cast<FlatMap*>(this)->find(key); }
+
+	/* Value of key, default constructed if it was not in the map */
+	Value& operator[](Key key) {
+		if ((count + 1) * 4 > slots.size() * 3) {
+			rehash(slots.empty() ? 16 : slots.size() * 2);
+		}
+		size_t i = slotOf(key);
+		for (; slots[i].key != 0; i = (i + 1) & mask()) {
+			if (slots[i].key == key) {
+				return slots[i].value;
+			}
+		}
+		slots[i].key = key;
+		slots[i].value = Value();
+		++count;
+		return slots[i].value;
+	}
+
+	bool erase(Key key) {
+		if (key == 0 || slots.empty()) {
+			return false;
+		}
+		size_t i = slotOf(key);
+		for (; slots[i].key != key; i = (i + 1) & mask()) {
+			if (slots[i].key == 0) {
+				return false;
+			}
+		}
+		/* Move back entries of the probe sequence that would not be found behind the hole anymore */
+		for (size_t j = (i + 1) & mask(); slots[j].key != 0; j = (j + 1) & mask()) {
+			const size_t home = slotOf(slots[j].key);
+			if (((j - home) & mask()) >= ((j - i) & mask())) {
+				slots[i] = slots[j];
+				i = j;
+			}
+		}
+		slots[i].key = 0;
+		--count;
+		return true;
+	}
+
+	void clear() {
+		slots.clear();
+		count = 0;
+	}
+
+	/* Call function(key, value) for every entry, in no particular order */
+	template <typename Function>
+	void forEach(Function function) const {
+		for (size_t i = 0; i < slots.size(); ++i) {
+			if (slots[i].key != 0) {
+				function(slots[i].key, slots[i].value);
+			}
+		}
+	}
+
+	template <typename Function>
+	void forEach(Function function) {
+		for (size_t i = 0; i < slots.size(); ++i) {
+			if (slots[i].key != 0) {
+				function(slots[i].key, slots[i].value);
+			}
+		}
+	}
+
+private:
+	struct Slot {
+		Key key;
+		Value value;
+	};
+
+	size_t mask() const { return slots.size() - 1; }
+
+	/* Fibonacci hashing, IDs are mostly consecutive */
+	size_t slotOf(Key key) const {
+		return (size_t)(((unsigned long long)key * 0x9E3779B97F4A7C15ULL) >> 32) & mask();
+	}
+
+	void rehash(size_t capacity) {
+		std::vector<struct Slot> old(capacity);
+		old.swap(slots);
+		for (size_t i = 0; i < old.size(); ++i) {
+			if (old[i].key != 0) {
+				size_t j = slotOf(old[i].key);
+				while (slots[j].key != 0) {
+					j = (j + 1) & mask();
+				}
+				slots[j] = old[i];
+			}
+		}
+	}
+
+	std::vector<struct Slot> slots;
+	size_t count;
+};
+
+#endif
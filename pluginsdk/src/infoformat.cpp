@@ -0,0 +1,112 @@
+/*
+ * Allocation free formatting of info text values
+ */
+
+#include <time.h>
+#include "infoformat.h"
+
+void TextWriter::append(const char* text, size_t length) {
+	const size_t space = (size_t)(end - position);
+	if (length > space) {
+		length = space;
+		overflow = true;
+	}
+	memcpy(position, text, length);
+	position += length;
+}
+
+void TextWriter::appendPadded(unsigned int value, int width) {
+	char digits[16];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+	for (int pad = width - (int)(result.ptr - digits); pad > 0; --pad) {
+		append('0');
+	}
+	append(digits, (size_t)(result.ptr - digits));
+}
+
+void TextWriter::appendFixed(uint64 scaled, int decimals) {
+	uint64 scale = 1;
+	for (int i = 0; i < decimals; ++i) {
+		scale *= 10;
+	}
+	appendNumber(scaled / scale);
+	if (decimals > 0) {
+		append('.');
+		appendPadded((unsigned int)(scaled % scale), decimals);
+	}
+}
+
+void TextWriter::appendBytes(uint64 bytes) {
+	static const char* const units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+	if (bytes < 1024) {
+		appendNumber(bytes);
+		append(' ');
+		append(units[0]);
+		return;
+	}
+
+	size_t unit = 1;
+	uint64 scale = 1024;
+	while (unit + 1 < sizeof(units) / sizeof(units[0]) && bytes / scale >= 1024) {
+		scale *= 1024;
+		++unit;
+	}
+	/* Hundredths rounded half up, carried into the integral part if needed */
+	const uint64 hundredths = (bytes % scale * 100 + scale / 2) / scale;
+	appendNumber(bytes / scale + hundredths / 100);
+	append('.');
+	appendPadded((unsigned int)(hundredths % 100), 2);
+	append(' ');
+	append(units[unit]);
+}
+
+void TextWriter::appendDate(uint64 timestamp) {
+	if (timestamp == 0) {
+		append("never");
+		return;
+	}
+
+	const time_t time = (time_t)timestamp;
+	struct tm local;
+#ifdef _WIN32
+	if (localtime_s(&local, &time) != 0) {
+#else
+	if (localtime_r(&time, &local) == NULL) {
+#endif
+		appendNumber(timestamp);
+		return;
+	}
+	appendNumber(local.tm_year + 1900);
+	append('-');
+	appendPadded(local.tm_mon + 1, 2);
+	append('-');
+	appendPadded(local.tm_mday, 2);
+	append(' ');
+	appendPadded(local.tm_hour, 2);
+	append(':');
+	appendPadded(local.tm_min, 2);
+	append(':');
+	appendPadded(local.tm_sec, 2);
+}
+
+void TextWriter::appendDuration(uint64 seconds) {
+	static const struct {
+		uint64 seconds;
+		char suffix;
+	} units[] = { { 86400, 'd' }, { 3600, 'h' }, { 60, 'm' }, { 1, 's' } };
+
+	bool written = false;
+	for (size_t i = 0; i < sizeof(units) / sizeof(units[0]); ++i) {
+		const uint64 count = seconds / units[i].seconds;
+		seconds %= units[i].seconds;
+		if (count == 0 && !written && units[i].seconds != 1) {
+			continue;
+		}
+		if (written) {
+			append(' ');
+		}
+		appendNumber(count);
+		append(units[i].suffix);
+		written = true;
+	}
+}
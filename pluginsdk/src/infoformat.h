@@ -0,0 +1,65 @@
+/*
+ * Allocation free formatting of info text values
+ */
+
+#ifndef INFOFORMAT_H
+#define INFOFORMAT_H
+
+#include <stddef.h>
+#include <string.h>
+#include <charconv>
+#include "teamspeak/public_definitions.h"
+
+/*
+ * Appends text and formatted values to a caller provided buffer. Nothing is allocated; output that does not fit
+ * is cut off and reported by truncated().
+ */
+class TextWriter {
+public:
+	TextWriter(char* buffer, size_t size) : begin(buffer), end(buffer + size), position(buffer), overflow(false) {}
+
+	const char* data() const { return begin; }
+	size_t length() const { return (size_t)(position - begin); }
+	bool truncated() const { return overflow; }
+
+	/* Drop everything written after length */
+	void rewind(size_t length) { position = begin + length; }
+
+	void append(const char* text, size_t length);
+	void append(const char* text) { append(text, strlen(text)); }
+	void append(char c) { append(&c, 1); }
+
+	template <typename T>
+	void appendNumber(T value) {
+		std::to_chars_result result = std::to_chars(position, end, value);
+		if (result.ec == std::errc()) {
+			position = result.ptr;
+		}
+		else {
+			overflow = true;
+		}
+	}
+
+	/* Number left padded with zeros to width digits */
+	void appendPadded(unsigned int value, int width);
+
+	/* Fixed point number given in units of 10^-decimals, e.g. 1234 with 2 decimals as "12.34" */
+	void appendFixed(uint64 scaled, int decimals);
+
+	/* Byte count scaled to B, KiB, MiB, GiB or TiB with two decimals, e.g. "1.50 MiB" */
+	void appendBytes(uint64 bytes);
+
+	/* Unix timestamp as local "YYYY-MM-DD hh:mm:ss", 0 as "never" */
+	void appendDate(uint64 timestamp);
+
+	/* Number of seconds as "3d 4h 5m 6s", leading zero units are omitted */
+	void appendDuration(uint64 seconds);
+
+private:
+	char* begin;
+	char* end;
+	char* position;
+	bool overflow;
+};
+
+#endif
@@ -0,0 +1,362 @@
+/*
+ * Event journal: the server events seen by the plugin, appended to size rotated binary files
+ */
+
+#include <string.h>
+#include <chrono>
+#include "journal.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define JOURNAL_MAX_VARINT 10
+#define JOURNAL_FIELDS 6
+#define JOURNAL_MASK_TEXT_TRUNCATED (1 << JOURNAL_FIELDS)
+
+/* fopen, MSVC wants fopen_s */
+static FILE* openFile(const char* path, const char* mode) {
+#ifdef _WIN32
+	FILE* file;
+	return fopen_s(&file, path, mode) == 0 ? file : NULL;
+#else
+	return fopen(path, mode);
+#endif
+}
+
+static void putVarint(std::vector<unsigned char>* out, uint64 value) {
+	while (value >= 0x80) {
+		out->push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out->push_back((unsigned char)value);
+}
+
+static size_t varintLength(uint64 value) {
+	size_t length = 1;
+	while (value >= 0x80) {
+		value >>= 7;
+		++length;
+	}
+	return length;
+}
+
+/* Returns false if the varint runs past end */
+static bool getVarint(const unsigned char** position, const unsigned char* end, uint64* value) {
+	*value = 0;
+	for (unsigned int shift = 0; *position < end && shift < 7 * JOURNAL_MAX_VARINT; shift += 7) {
+		const unsigned char byte = *(*position)++;
+		*value |= (uint64)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Time deltas are signed as the clock may be set back */
+static uint64 zigzag(uint64 time, uint64 base) {
+	const long long delta = (long long)(time - base);
+	return ((uint64)delta << 1) ^ (uint64)(delta >> 63);
+}
+
+static uint64 unzigzag(uint64 value, uint64 base) {
+	return base + ((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static uint64 wallClock() {
+	return (uint64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static uint64 JournalRecord::* const recordFields[JOURNAL_FIELDS] = {
+	&JournalRecord::clientID,
+	&JournalRecord::channelID,
+	&JournalRecord::otherChannelID,
+	&JournalRecord::groupID,
+	&JournalRecord::invokerID,
+	&JournalRecord::value,
+};
+
+JournalWriter::JournalWriter() : segmentSize(0), segments(0), bufferSize(0), file(NULL), fileSize(0), lastTime(0) {}
+
+JournalWriter::~JournalWriter() {
+	close();
+}
+
+bool JournalWriter::open(const char* path, size_t segmentSize, unsigned int segments, size_t bufferSize) {
+	close();
+	this->path = path;
+	this->segmentSize = segmentSize;
+	this->segments = segments > 0 ? segments : 1;
+	this->bufferSize = bufferSize;
+	buffer.reserve(bufferSize);
+	if (reopenSegment()) {
+		return true;
+	}
+	FILE* existing = openFile(path, "rb");
+	if (existing) {
+		fclose(existing);
+		rotate(0);  /* Full or damaged, it becomes the previous segment */
+		return file != NULL;
+	}
+	return openSegment(wallClock());
+}
+
+void JournalWriter::close() {
+	if (file) {
+		flush();
+		fclose(file);
+		file = NULL;
+	}
+}
+
+void JournalWriter::append(const struct JournalRecord& record) {
+	if (!file) {
+		return;
+	}
+
+	unsigned char mask = 0;
+	size_t length = 2 + varintLength(zigzag(record.time, lastTime)) + varintLength(record.serverConnectionHandlerID) + record.textLength;
+	for (size_t i = 0; i < JOURNAL_FIELDS; ++i) {
+		if (record.*recordFields[i] != 0) {
+			mask |= (unsigned char)(1 << i);
+			length += varintLength(record.*recordFields[i]);
+		}
+	}
+	if (record.textTruncated) {
+		mask |= JOURNAL_MASK_TEXT_TRUNCATED;
+	}
+	if (fileSize + buffer.size() + varintLength(length) + length > segmentSize && fileSize > JOURNAL_HEADER_SIZE) {
+		rotate(record.time);
+	}
+
+	putVarint(&buffer, length);
+	buffer.push_back((unsigned char)record.type);
+	buffer.push_back(mask);
+	putVarint(&buffer, zigzag(record.time, lastTime));
+	putVarint(&buffer, record.serverConnectionHandlerID);
+	for (size_t i = 0; i < JOURNAL_FIELDS; ++i) {
+		if (mask & (1 << i)) {
+			putVarint(&buffer, record.*recordFields[i]);
+		}
+	}
+	buffer.insert(buffer.end(), (const unsigned char*)record.text, (const unsigned char*)record.text + record.textLength);
+	lastTime = record.time;
+
+	if (buffer.size() >= bufferSize) {
+		flush();
+	}
+}
+
+void JournalWriter::flush() {
+	if (!file || buffer.empty()) {
+		return;
+	}
+	if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+		printf("Error writing journal %s\n", path.c_str());
+	}
+	fflush(file);
+	fileSize += buffer.size();
+	buffer.clear();
+}
+
+/* Continue the segment at path if all its records decode and it has room left, the last one is the base of the next delta */
+bool JournalWriter::reopenSegment() {
+	JournalReader reader;
+	if (!reader.open(path.c_str())) {
+		return false;
+	}
+	uint64 time = reader.startTime();
+	struct JournalRecord record;
+	while (reader.next(&record)) {
+		time = record.time;
+	}
+	if (!reader.atEnd() || reader.length() >= segmentSize) {
+		return false;
+	}
+	const size_t length = reader.length();
+	reader.close();
+	file = openFile(path.c_str(), "ab");
+	if (!file) {
+		printf("Error opening journal %s\n", path.c_str());
+		return false;
+	}
+	fileSize = length;
+	lastTime = time;
+	return true;
+}
+
+/* Start a new segment at path, the previous one must have been moved away */
+bool JournalWriter::openSegment(uint64 time) {
+	file = openFile(path.c_str(), "wb");
+	if (!file) {
+		printf("Error opening journal %s\n", path.c_str());
+		return false;
+	}
+	unsigned char header[JOURNAL_HEADER_SIZE];
+	memcpy(header, JOURNAL_MAGIC, 3);
+	header[3] = JOURNAL_VERSION;
+	for (int i = 0; i < 8; ++i) {
+		header[4 + i] = (unsigned char)(time >> (8 * i));
+	}
+	fwrite(header, 1, sizeof(header), file);
+	fileSize = sizeof(header);
+	lastTime = time;
+	return true;
+}
+
+/* Close the current segment, shift the older ones up by one and start a new one */
+void JournalWriter::rotate(uint64 time) {
+	if (file) {
+		flush();
+		fclose(file);
+		file = NULL;
+	}
+	char from[512];
+	char to[512];
+	snprintf(to, sizeof(to), "%s.%u", path.c_str(), segments - 1);
+	remove(to);
+	for (unsigned int i = segments - 1; i > 1; --i) {
+		snprintf(from, sizeof(from), "%s.%u", path.c_str(), i - 1);
+		snprintf(to, sizeof(to), "%s.%u", path.c_str(), i);
+		rename(from, to);
+	}
+	if (segments > 1) {
+		snprintf(to, sizeof(to), "%s.1", path.c_str());
+		rename(path.c_str(), to);
+	}
+	else {
+		remove(path.c_str());
+	}
+	if (!time) {
+		/* Opening: take the wall clock, records carry their own times afterwards */
+		time = wallClock();
+	}
+	openSegment(time);
+}
+
+JournalReader::JournalReader() : data(NULL), size(0), position(0), start(0), lastTime(0) {
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#endif
+}
+
+JournalReader::~JournalReader() {
+	close();
+}
+
+bool JournalReader::open(const char* path) {
+	close();
+#ifdef _WIN32
+	fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < JOURNAL_HEADER_SIZE) {
+		close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	data = mappingHandle ? (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : NULL;
+	size = (size_t)fileSize.QuadPart;
+#else
+	const int descriptor = ::open(path, O_RDONLY);
+	if (descriptor < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) != 0 || status.st_size < JOURNAL_HEADER_SIZE) {
+		::close(descriptor);
+		return false;
+	}
+	void* mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor);
+	data = mapping != MAP_FAILED ? (const unsigned char*)mapping : NULL;
+	size = (size_t)status.st_size;
+#endif
+	if (!data || memcmp(data, JOURNAL_MAGIC, 3) != 0 || data[3] != JOURNAL_VERSION) {
+		close();
+		return false;
+	}
+	start = 0;
+	for (int i = 0; i < 8; ++i) {
+		start |= (uint64)data[4 + i] << (8 * i);
+	}
+	lastTime = start;
+	position = JOURNAL_HEADER_SIZE;
+	return true;
+}
+
+void JournalReader::close() {
+#ifdef _WIN32
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+	}
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#else
+	if (data) {
+		munmap((void*)data, size);
+	}
+#endif
+	data = NULL;
+	size = 0;
+	position = 0;
+}
+
+bool JournalReader::next(struct JournalRecord* record) {
+	if (!data || position >= size) {
+		return false;
+	}
+	const unsigned char* cursor = data + position;
+	const unsigned char* const fileEnd = data + size;
+	uint64 length;
+	if (!getVarint(&cursor, fileEnd, &length) || length < 2 || length > (uint64)(fileEnd - cursor)) {
+		return false;
+	}
+	const unsigned char* const end = cursor + length;
+
+	memset(record, 0, sizeof(*record));
+	record->type = *cursor++;
+	const unsigned char mask = *cursor++;
+	uint64 delta;
+	if (!getVarint(&cursor, end, &delta) || !getVarint(&cursor, end, &record->serverConnectionHandlerID)) {
+		return false;
+	}
+	record->time = unzigzag(delta, lastTime);
+	for (size_t i = 0; i < JOURNAL_FIELDS; ++i) {
+		if ((mask & (1 << i)) && !getVarint(&cursor, end, &(record->*recordFields[i]))) {
+			return false;
+		}
+	}
+	record->text = (const char*)cursor;
+	record->textLength = (size_t)(end - cursor);
+	record->textTruncated = (mask & JOURNAL_MASK_TEXT_TRUNCATED) != 0;
+	lastTime = record->time;
+	position = (size_t)(end - data);
+	return true;
+}
+
+const char* journalTypeName(unsigned int type) {
+	static const char* const names[] = {
+		"unknown", "connected", "disconnected", "client moved", "client timeout", "client kicked from channel",
+		"client kicked from server", "client banned", "talk status", "client updated", "channel created",
+		"channel deleted", "channel moved", "channel edited", "server edited", "text message", "server group added",
+		"server group removed", "channel group changed", "client subscription", "channel subscribed",
+		"channel unsubscribed", "events dropped",
+	};
+	return type < sizeof(names) / sizeof(names[0]) ? names[type] : names[0];
+}
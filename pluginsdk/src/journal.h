@@ -0,0 +1,140 @@
+/*
+ * Event journal: the server events seen by the plugin, appended to size rotated binary files
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "teamspeak/public_definitions.h"
+
+/* Record types, stored in the files so never renumber them */
+#define JOURNAL_CONNECTED             1
+#define JOURNAL_DISCONNECTED          2
+#define JOURNAL_CLIENT_MOVED          3   /* channelID 0 if the client left the server */
+#define JOURNAL_CLIENT_TIMEOUT        4
+#define JOURNAL_CLIENT_KICKED_CHANNEL 5
+#define JOURNAL_CLIENT_KICKED_SERVER  6
+#define JOURNAL_CLIENT_BANNED         7   /* value is the ban duration in seconds */
+#define JOURNAL_TALK_STATUS           8   /* value is the TalkStatus */
+#define JOURNAL_CLIENT_UPDATED        9
+#define JOURNAL_CHANNEL_CREATED       10  /* otherChannelID is the parent */
+#define JOURNAL_CHANNEL_DELETED       11
+#define JOURNAL_CHANNEL_MOVED         12  /* otherChannelID is the new parent */
+#define JOURNAL_CHANNEL_EDITED        13
+#define JOURNAL_SERVER_EDITED         14
+#define JOURNAL_TEXT_MESSAGE          15  /* value is the TextMessageTargetMode, clientID the receiver */
+#define JOURNAL_SERVER_GROUP_ADDED    16
+#define JOURNAL_SERVER_GROUP_REMOVED  17
+#define JOURNAL_CHANNEL_GROUP_CHANGED 18
+#define JOURNAL_CLIENT_SUBSCRIPTION   19  /* channelID 0 if the client went out of view */
+#define JOURNAL_CHANNEL_SUBSCRIBED    20
+#define JOURNAL_CHANNEL_UNSUBSCRIBED  21
+#define JOURNAL_EVENTS_DROPPED        22  /* Gap: value events of the connection were lost to a full event queue */
+
+/* A decoded record, fields not used by the type are 0 */
+struct JournalRecord {
+	unsigned int type;
+	uint64 time;                      /* Milliseconds since 1970 */
+	uint64 serverConnectionHandlerID;
+	uint64 clientID;
+	uint64 channelID;
+	uint64 otherChannelID;            /* Channel the client came from, or the parent of a channel */
+	uint64 groupID;
+	uint64 invokerID;
+	uint64 value;
+	const char* text;                 /* Message or reason, not terminated. Points into the reader's mapping. */
+	size_t textLength;
+	bool textTruncated;               /* The text was cut before it was journaled, by the plugin to EVENT_TEXT_SIZE */
+};
+
+/*
+ * File format, all numbers are unsigned LEB128 varints unless noted:
+ *   header:  "TSJ" version(byte) start time(8 bytes little endian, milliseconds since 1970)
+ *   record:  length of the rest, type(byte), mask(byte), time delta (zigzag, ms since the previous record or the
+ *            start), schid, then clientID, channelID, otherChannelID, groupID, invokerID, value for every bit set in
+ *            mask (bit 0 = clientID), and the text up to the end of the record. Mask bit 6 is set if the text is not
+ *            the whole message or reason but its start.
+ * A typical record takes 8 to 12 bytes plus its text. A record cut off by a crash ends the file for the reader.
+ */
+#define JOURNAL_MAGIC "TSJ"
+#define JOURNAL_VERSION 1
+#define JOURNAL_HEADER_SIZE 12
+
+/*
+ * Writes records into a write-behind buffer, which goes to disk when it is full or flush is called. The current segment
+ * is <path>, older ones <path>.1 up to <path>.<segments - 1>; a segment reaching segmentSize moves them all up by one
+ * and drops the oldest. Opening continues the current segment of an earlier session, unless it is full or ends in a
+ * damaged record. Not thread safe, the plugin writes from its event worker only.
+ */
+class JournalWriter {
+public:
+	JournalWriter();
+	~JournalWriter();
+
+	/* Returns false if the current segment can neither be continued nor created */
+	bool open(const char* path, size_t segmentSize, unsigned int segments, size_t bufferSize);
+	void close();
+	bool isOpen() const { return file != NULL; }
+
+	void append(const struct JournalRecord& record);
+	/* Write the buffer to the file */
+	void flush();
+	/* Bytes waiting in the buffer */
+	size_t pending() const { return buffer.size(); }
+
+private:
+	bool reopenSegment();
+	bool openSegment(uint64 time);
+	void rotate(uint64 time);
+
+	std::string path;
+	size_t segmentSize;
+	unsigned int segments;
+	size_t bufferSize;
+	FILE* file;
+	size_t fileSize;             /* Bytes written to the current segment */
+	uint64 lastTime;             /* Time of the last record, base of the next delta */
+	std::vector<unsigned char> buffer;
+};
+
+/* Maps a segment into memory and decodes its records in place */
+class JournalReader {
+public:
+	JournalReader();
+	~JournalReader();
+
+	/* Returns false if the file cannot be mapped or is no journal */
+	bool open(const char* path);
+	void close();
+
+	uint64 startTime() const { return start; }
+	/*
+	 * Decode the next record, returns false at the end of the segment or at a damaged record. JOURNAL_EVENTS_DROPPED
+	 * records mark where the plugin lost events, the records around them are not a complete history.
+	 */
+	bool next(struct JournalRecord* record);
+	/* All records decoded, no damaged one stopped next early */
+	bool atEnd() const { return data && position == size; }
+	/* Bytes of the segment, the header included */
+	size_t length() const { return size; }
+
+private:
+	const unsigned char* data;
+	size_t size;
+	size_t position;
+	uint64 start;
+	uint64 lastTime;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
+
+/* Name of a record type for printing */
+const char* journalTypeName(unsigned int type);
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Name cache: UIDs, database IDs and nicknames of the clients of a server, kept in a memory mapped file across sessions
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "namecache.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* FNV-1a */
+static size_t hashOf(const char* text) {
+	unsigned int hash = 2166136261u;
+	for (; *text; ++text) {
+		hash = (hash ^ (unsigned char)*text) * 16777619u;
+	}
+	return hash;
+}
+
+/* Fibonacci hashing, database IDs are consecutive */
+static size_t hashOf(uint64 databaseID) {
+	return (size_t)((databaseID * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/* Copy text into a field of size bytes, cutting it at a UTF-8 character boundary if it does not fit */
+static void copyField(char* field, size_t size, const char* text) {
+	size_t length = strlen(text);
+	if (length >= size) {
+		length = size - 1;
+		while (length > 0 && (text[length] & 0xC0) == 0x80) {
+			--length;
+		}
+	}
+	memcpy(field, text, length);
+	field[length] = '\0';
+}
+
+NameCache::NameCache() : data(NULL), mappedSize(0) {
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#else
+	descriptor = -1;
+#endif
+}
+
+NameCache::~NameCache() {
+	close();
+}
+
+size_t NameCache::fileSize(unsigned int slots) {
+	return sizeof(struct Header) + (size_t)slots * (sizeof(struct NameRecord) + sizeof(unsigned int));
+}
+
+bool NameCache::open(const char* path) {
+	close();
+	this->path = path;
+#ifdef _WIN32
+	fileHandle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER existing;
+	const size_t size = GetFileSizeEx(fileHandle, &existing) ? (size_t)existing.QuadPart : 0;
+#else
+	descriptor = ::open(path, O_RDWR | O_CREAT, 0644);
+	if (descriptor < 0) {
+		return false;
+	}
+	struct stat status;
+	const size_t size = fstat(descriptor, &status) == 0 ? (size_t)status.st_size : 0;
+#endif
+
+	if (size >= sizeof(struct Header) && map(size)) {
+		const struct Header* known = header();
+		const unsigned int slots = known->slots;
+		if (memcmp(known->magic, NAMECACHE_MAGIC, 4) == 0 && known->version == NAMECACHE_VERSION &&
+		    slots >= NAMECACHE_MIN_SLOTS && slots <= NAMECACHE_MAX_SLOTS && (slots & (slots - 1)) == 0 &&
+		    size == fileSize(slots) && known->count < slots) {
+			return true;
+		}
+		printf("Name cache %s is damaged, starting over\n", path);
+		unmap();
+	}
+
+	if (!map(fileSize(NAMECACHE_MIN_SLOTS))) {
+		close();
+		return false;
+	}
+	memset(data, 0, mappedSize);
+	memcpy(header()->magic, NAMECACHE_MAGIC, 4);
+	header()->version = NAMECACHE_VERSION;
+	header()->slots = NAMECACHE_MIN_SLOTS;
+	return true;
+}
+
+void NameCache::close() {
+	unmap();
+#ifdef _WIN32
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (descriptor >= 0) {
+		::close(descriptor);
+		descriptor = -1;
+	}
+#endif
+}
+
+/* Map size bytes of the file, growing it if it is shorter */
+bool NameCache::map(size_t size) {
+#ifdef _WIN32
+	const unsigned long long size64 = size;
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READWRITE, (DWORD)(size64 >> 32), (DWORD)size64, NULL);
+	data = mappingHandle ? (unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size) : NULL;
+#else
+	void* mapping = ftruncate(descriptor, (off_t)size) == 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0) : MAP_FAILED;
+	data = mapping != MAP_FAILED ? (unsigned char*)mapping : NULL;
+#endif
+	if (!data) {
+		unmap();
+		return false;
+	}
+	mappedSize = size;
+	return true;
+}
+
+void NameCache::unmap() {
+#ifdef _WIN32
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle) {
+		CloseHandle(mappingHandle);
+		mappingHandle = NULL;
+	}
+#else
+	if (data) {
+		munmap(data, mappedSize);
+	}
+#endif
+	data = NULL;
+	mappedSize = 0;
+}
+
+size_t NameCache::slotOf(const char* uid) const {
+	const struct NameRecord* table = records();
+	const size_t mask = header()->slots - 1;
+	for (size_t i = hashOf(uid) & mask; ; i = (i + 1) & mask) {
+		if (table[i].uid[0] == '\0' || strncmp(table[i].uid, uid, NAMECACHE_UID_SIZE) == 0) {
+			return i;
+		}
+	}
+}
+
+void NameCache::indexDatabaseID(unsigned int record) {
+	unsigned int* table = index();
+	const size_t mask = header()->slots - 1;
+	size_t i = hashOf(records()[record].databaseID) & mask;
+	for (size_t probes = 0; probes <= mask; ++probes, i = (i + 1) & mask) {
+		if (table[i] == 0 || table[i] == record + 1) {
+			table[i] = record + 1;
+			return;
+		}
+	}
+}
+
+bool NameCache::rebuild(unsigned int slots) {
+	std::vector<struct NameRecord> kept;
+	kept.reserve(header()->count);
+	const struct NameRecord* table = records();
+	for (unsigned int i = 0; i < header()->slots; ++i) {
+		if (table[i].uid[0] != '\0') {
+			kept.push_back(table[i]);
+		}
+	}
+	/* Room for half as many again before the next rebuild */
+	const size_t keep = std::min(kept.size(), (size_t)slots / 2);
+	std::partial_sort(kept.begin(), kept.begin() + keep, kept.end(), [](const struct NameRecord& a, const struct NameRecord& b) {
+		return a.lastSeen > b.lastSeen;
+	});
+	kept.resize(keep);
+
+	unmap();
+	if (!map(fileSize(slots))) {
+		printf("Error resizing name cache %s\n", path.c_str());
+		close();
+		return false;
+	}
+	memset(data, 0, mappedSize);
+	memcpy(header()->magic, NAMECACHE_MAGIC, 4);
+	header()->version = NAMECACHE_VERSION;
+	header()->slots = slots;
+	for (size_t i = 0; i < kept.size(); ++i) {
+		const size_t slot = slotOf(kept[i].uid);
+		records()[slot] = kept[i];
+		++header()->count;
+		if (kept[i].databaseID) {
+			indexDatabaseID((unsigned int)slot);
+		}
+	}
+	return true;
+}
+
+void NameCache::update(const char* uid, uint64 databaseID, const char* nickname, uint64 time) {
+	const size_t uidLength = strlen(uid);
+	if (!data || uid[0] == '\0' || uidLength >= NAMECACHE_UID_SIZE) {
+		return;
+	}
+	size_t slot = slotOf(uid);
+	if (records()[slot].uid[0] == '\0') {
+		if ((size_t)(header()->count + 1) * 4 > (size_t)header()->slots * 3) {
+			if (!rebuild(std::min(header()->slots * 2, (unsigned int)NAMECACHE_MAX_SLOTS))) {
+				return;
+			}
+			slot = slotOf(uid);
+		}
+		memcpy(records()[slot].uid, uid, uidLength + 1);
+		++header()->count;
+	}
+
+	struct NameRecord& record = records()[slot];
+	record.lastSeen = time;
+	if (databaseID && databaseID != record.databaseID) {
+		record.databaseID = databaseID;
+		indexDatabaseID((unsigned int)slot);
+	}
+	if (nickname && nickname[0] != '\0') {
+		copyField(record.nickname, sizeof(record.nickname), nickname);
+	}
+}
+
+bool NameCache::findByUID(const char* uid, struct NameRecord* record) const {
+	if (!data || uid[0] == '\0' || strlen(uid) >= NAMECACHE_UID_SIZE) {
+		return false;
+	}
+	const struct NameRecord& found = records()[slotOf(uid)];
+	if (found.uid[0] == '\0') {
+		return false;
+	}
+	*record = found;
+	return true;
+}
+
+bool NameCache::findByDatabaseID(uint64 databaseID, struct NameRecord* record) const {
+	if (!data || databaseID == 0) {
+		return false;
+	}
+	const unsigned int* table = index();
+	const size_t mask = header()->slots - 1;
+	size_t i = hashOf(databaseID) & mask;
+	for (size_t probes = 0; probes <= mask && table[i] != 0; ++probes, i = (i + 1) & mask) {
+		const struct NameRecord& found = records()[table[i] - 1];
+		if (found.databaseID == databaseID) {  /* Entries of a changed database ID stay behind until the next rebuild */
+			*record = found;
+			return true;
+		}
+	}
+	return false;
+}
+
+size_t NameCache::size() const {
+	return data ? header()->count : 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Name cache: UIDs, database IDs and nicknames of the clients of a server, kept in a memory mapped file across sessions
+ */
+
+#ifndef NAMECACHE_H
+#define NAMECACHE_H
+
+#include <stddef.h>
+#include <string>
+#include "teamspeak/public_definitions.h"
+
+#define NAMECACHE_MAGIC "TSNC"
+#define NAMECACHE_VERSION 1
+#define NAMECACHE_UID_SIZE 32        /* UIDs are 28 characters */
+#define NAMECACHE_NICKNAME_SIZE 128  /* Nicknames are up to 30 characters of up to 4 bytes, longer ones are cut */
+#define NAMECACHE_MIN_SLOTS 1024
+#define NAMECACHE_MAX_SLOTS 65536    /* 11.5 MiB; when full the clients seen least recently are dropped */
+
+struct NameRecord {
+	char uid[NAMECACHE_UID_SIZE];            /* Empty for a free slot */
+	uint64 databaseID;                       /* 0 if unknown */
+	uint64 lastSeen;                         /* Seconds since 1970 */
+	char nickname[NAMECACHE_NICKNAME_SIZE];  /* Empty if unknown */
+};
+
+/*
+ * File format, native byte order:
+ *   header:  magic(4) version(4) slots(4) count(4)
+ *   records: slots NameRecords, an open addressing table keyed by UID
+ *   index:   slots 32 bit numbers, an open addressing table keyed by database ID holding record number + 1
+ * Both tables live in the mapping, so a lookup right after open touches a few pages and nothing is loaded up front. A
+ * file that does not match the format is started over. Not thread safe.
+ */
+class NameCache {
+public:
+	NameCache();
+	~NameCache();
+
+	/* Map the file, creating it if needed. Returns false if it cannot be created or mapped. */
+	bool open(const char* path);
+	void close();
+	bool isOpen() const { return data != NULL; }
+
+	/* Store what is known about a client, databaseID 0 and nickname NULL keep the stored values */
+	void update(const char* uid, uint64 databaseID, const char* nickname, uint64 time);
+	bool findByUID(const char* uid, struct NameRecord* record) const;
+	bool findByDatabaseID(uint64 databaseID, struct NameRecord* record) const;
+	size_t size() const;
+
+private:
+	struct Header {
+		char magic[4];
+		unsigned int version;
+		unsigned int slots;
+		unsigned int count;
+	};
+
+	static size_t fileSize(unsigned int slots);
+	struct Header* header() const { return (struct Header*)data; }
+	struct NameRecord* records() const { return (struct NameRecord*)(data + sizeof(struct Header)); }
+	unsigned int* index() const { return (unsigned int*)(data + sizeof(struct Header) + header()->slots * sizeof(struct NameRecord)); }
+
+	/* Slot of uid in the records, or the free slot it would go into */
+	size_t slotOf(const char* uid) const;
+	void indexDatabaseID(unsigned int record);
+	/* Resize the file to slots, keeping the records seen most recently that fit */
+	bool rebuild(unsigned int slots);
+	bool map(size_t size);
+	void unmap();
+
+	std::string path;
+	unsigned char* data;
+	size_t mappedSize;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int descriptor;
+#endif
+};
+
+#endif
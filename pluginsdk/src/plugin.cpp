@@ -1,1032 +1,3550 @@
-/*
- * TeamSpeak 3 demo plugin
- *
- * Copyright (c) 2008-2016 TeamSpeak Systems GmbH
- */
-
-#ifdef _WIN32
-#pragma warning (disable : 4100)  /* Disable Unreferenced parameter warning */
-#include <Windows.h>
-#endif
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <assert.h>
-#include "teamspeak/public_errors.h"
-#include "teamspeak/public_errors_rare.h"
-#include "teamspeak/public_definitions.h"
-#include "teamspeak/public_rare_definitions.h"
-#include "teamspeak/clientlib_publicdefinitions.h"
-#include "ts3_functions.h"
-#include "plugin.h"
-#include <string>
-#include <thread>
-
-static struct TS3Functions ts3Functions;
-
-#ifdef _WIN32
-#define _strcpy(dest, destSize, src) strcpy_s(dest, destSize, src)
-#define snprintf sprintf_s
-#else
-#define _strcpy(dest, destSize, src) { strncpy(dest, src, destSize-1); (dest)[destSize-1] = '\0'; }
-#endif
-
-#define PLUGIN_API_VERSION 23
-#define PLUGIN_VERSION "1"
-
-#define PATH_BUFSIZE 512
-#define COMMAND_BUFSIZE 128
-#define INFODATA_BUFSIZE 7000
-#define SERVERINFO_BUFSIZE 256
-#define CHANNELINFO_BUFSIZE 512
-#define RETURNCODE_BUFSIZE 128
-
-static char* pluginID = NULL;
-
-#ifdef _WIN32
-/* Helper function to convert wchar_T to Utf-8 encoded strings on Windows */
-static int wcharToUtf8(const wchar_t* str, char** result) {
-	int outlen = WideCharToMultiByte(CP_UTF8, 0, str, -1, 0, 0, 0, 0);
-	*result = (char*)malloc(outlen);
-	if(WideCharToMultiByte(CP_UTF8, 0, str, -1, *result, outlen, 0, 0) == 0) {
-		*result = NULL;
-		return -1;
-	}
-	return 0;
-}
-#endif
-
-/*********************************** Required functions ************************************/
-/*
- * If any of these required functions is not implemented, TS3 will refuse to load the plugin
- */
-
-/* Unique name identifying this plugin */
-const char* ts3plugin_name() {
-#ifdef _WIN32
-	/* TeamSpeak expects UTF-8 encoded characters. Following demonstrates a possibility how to convert UTF-16 wchar_t into UTF-8. */
-	static char* result = NULL;  /* Static variable so it's allocated only once */
-	if(!result) {
-		const wchar_t* name = L"Too Much Informations";
-		if(wcharToUtf8(name, &result) == -1) {  /* Convert name into UTF-8 encoded result */
-			result = "Too Much Informations";  /* Conversion failed, fallback here */
-		}
-	}
-	return result;
-#else
-	return "Too Much Informations";
-#endif
-}
-
-/* Plugin version */
-const char* ts3plugin_version() {
-    return PLUGIN_VERSION;
-}
-
-/* Plugin API version. Must be the same as the clients API major version, else the plugin fails to load. */
-int ts3plugin_apiVersion() {
-	return PLUGIN_API_VERSION;
-}
-
-/* Plugin author */
-const char* ts3plugin_author() {
-	/* If you want to use wchar_t, see ts3plugin_name() on how to use */
-    return "shitty720";
-}
-
-/* Plugin description */
-const char* ts3plugin_description() {
-	/* If you want to use wchar_t, see ts3plugin_name() on how to use */
-    return "Too Much Informations";
-}
-
-/* Set TeamSpeak 3 callback functions */
-void ts3plugin_setFunctionPointers(const struct TS3Functions funcs) {
-    ts3Functions = funcs;
-}
-
-/*
- * Custom code called right after loading the plugin. Returns 0 on success, 1 on failure.
- * If the function returns 1 on failure, the plugin will be unloaded again.
- */
-int ts3plugin_init() {
-    char appPath[PATH_BUFSIZE];
-    char resourcesPath[PATH_BUFSIZE];
-    char configPath[PATH_BUFSIZE];
-	char pluginPath[PATH_BUFSIZE];
-
-    /* Your plugin init code here */
-    printf("client user data: init\n");
-
-    /* Example on how to query application, resources and configuration paths from client */
-    /* Note: Console client returns empty string for app and resources path */
-    ts3Functions.getAppPath(appPath, PATH_BUFSIZE);
-    ts3Functions.getResourcesPath(resourcesPath, PATH_BUFSIZE);
-    ts3Functions.getConfigPath(configPath, PATH_BUFSIZE);
-	ts3Functions.getPluginPath(pluginPath, PATH_BUFSIZE);
-
-	//printf("PLUGIN: App path: %s\nResources path: %s\nConfig path: %s\nPlugin path: %s\n", appPath, resourcesPath, configPath, pluginPath);
-
-    return 0;  /* 0 = success, 1 = failure, -2 = failure but client will not show a "failed to load" warning */
-	/* -2 is a very special case and should only be used if a plugin displays a dialog (e.g. overlay) asking the user to disable
-	 * the plugin again, avoiding the show another dialog by the client telling the user the plugin failed to load.
-	 * For normal case, if a plugin really failed to load because of an error, the correct return value is 1. */
-}
-
-/* Custom code called right before the plugin is unloaded */
-void ts3plugin_shutdown() {
-    /* Your plugin cleanup code here */
-    printf("client user data: shutdown\n");
-
-	/*
-	 * Note:
-	 * If your plugin implements a settings dialog, it must be closed and deleted here, else the
-	 * TeamSpeak client will most likely crash (DLL removed but dialog from DLL code still open).
-	 */
-
-	/* Free pluginID if we registered it */
-	if(pluginID) {
-		free(pluginID);
-		pluginID = NULL;
-	}
-}
-
-/****************************** Optional functions ********************************/
-/*
- * Following functions are optional, if not needed you don't need to implement them.
- */
-
-/* Tell client if plugin offers a configuration window. If this function is not implemented, it's an assumed "does not offer" (PLUGIN_OFFERS_NO_CONFIGURE). */
-int ts3plugin_offersConfigure() {
-	//printf("PLUGIN: offersConfigure\n");
-	/*
-	 * Return values:
-	 * PLUGIN_OFFERS_NO_CONFIGURE         - Plugin does not implement ts3plugin_configure
-	 * PLUGIN_OFFERS_CONFIGURE_NEW_THREAD - Plugin does implement ts3plugin_configure and requests to run this function in an own thread
-	 * PLUGIN_OFFERS_CONFIGURE_QT_THREAD  - Plugin does implement ts3plugin_configure and requests to run this function in the Qt GUI thread
-	 */
-	return PLUGIN_OFFERS_NO_CONFIGURE;  /* In this case ts3plugin_configure does not need to be implemented */
-}
-
-/* Plugin might offer a configuration window. If ts3plugin_offersConfigure returns 0, this function does not need to be implemented. */
-void ts3plugin_configure(void* handle, void* qParentWidget) {
-   // printf("PLUGIN: configure\n");
-}
-
-/*
- * If the plugin wants to use error return codes, plugin commands, hotkeys or menu items, it needs to register a command ID. This function will be
- * automatically called after the plugin was initialized. This function is optional. If you don't use these features, this function can be omitted.
- * Note the passed pluginID parameter is no longer valid after calling this function, so you must copy it and store it in the plugin.
- */
-void ts3plugin_registerPluginID(const char* id) {
-	const size_t sz = strlen(id) + 1;
-	pluginID = (char*)malloc(sz * sizeof(char));
-	_strcpy(pluginID, sz, id);  /* The id buffer will invalidate after exiting this function */
-	//printf("PLUGIN: registerPluginID: %s\n", pluginID);
-}
-
-/* Plugin command keyword. Return NULL or "" if not used. */
-const char* ts3plugin_commandKeyword() {
-	return "";
-}
-
-/* Plugin processes console command. Return 0 if plugin handled the command, 1 if not handled. */
-int ts3plugin_processCommand(uint64 serverConnectionHandlerID, const char* command) {
-	
-	return 0;  /* Plugin handled command */
-}
-
-/* Client changed current server connection handler */
-void ts3plugin_currentServerConnectionChanged(uint64 serverConnectionHandlerID) {
-    printf("PLUGIN: currentServerConnectionChanged %llu (%llu)\n", (long long unsigned int)serverConnectionHandlerID, (long long unsigned int)ts3Functions.getCurrentServerConnectionHandlerID());
-}
-
-/*
- * Implement the following three functions when the plugin should display a line in the server/channel/client info.
- * If any of ts3plugin_infoTitle, ts3plugin_infoData or ts3plugin_freeMemory is missing, the info text will not be displayed.
- */
-
-/* Static title shown in the left column in the info frame */
-const char* ts3plugin_infoTitle() {
-	return "Informations";
-}
-
-/*
- * Dynamic content shown in the right column in the info frame. Memory for the data string needs to be allocated in this
- * function. The client will call ts3plugin_freeMemory once done with the string to release the allocated memory again.
- * Check the parameter "type" if you want to implement this feature only for specific item types. Set the parameter
- * "data" to NULL to have the client ignore the info data.
- */
-
-std::string getChannelCodec(int a) {
-
-	switch (a) {
-	case CODEC_SPEEX_NARROWBAND:
-		return std::string("CODEC_SPEEX_NARROWBAND");
-		break;
-	case CODEC_SPEEX_WIDEBAND:
-		return std::string("CODEC_SPEEX_WIDEBAND");
-		break;
-	case CODEC_SPEEX_ULTRAWIDEBAND:
-		return std::string("CODEC_SPEEX_ULTRAWIDEBAND");
-		break;
-	case CODEC_CELT_MONO:
-		return std::string("CODEC_CELT_MONO");
-		break;
-	case CODEC_OPUS_VOICE:
-		return std::string("CODEC_OPUS_VOICE");
-		break;
-	case CODEC_OPUS_MUSIC:
-		return std::string("CODEC_OPUS_MUSIC");
-		break;
-	default:
-		return std::string("error");
-		break;
-	}
-}
-
-template <typename T>
-std::string convertoString(T a) {
-	return std::to_string(a);
-}
-
-void ts3plugin_infoData(uint64 serverConnectionHandlerID, uint64 id, enum PluginItemType type, char** data) {
-	std::string infodata = ""; 
-	char *buffer = "";
-	int bufferInt = 0;
-	uint64 bufferUInt = 0;
-	double bufferD = 0;
-
-	
-
-	/* For demonstration purpose, display the name of the currently selected server, channel or client. */
-	switch (type) {
-	case PLUGIN_SERVER: {
-		//myid
-		anyID myid;
-		ts3Functions.getClientID(serverConnectionHandlerID, &myid);
-
-
-		//server UID
-		if (ts3Functions.getServerVariableAsString(serverConnectionHandlerID, VIRTUALSERVER_UNIQUE_IDENTIFIER, &buffer) != ERROR_ok) {
-			printf("Error getting VIRTUALSERVER_UNIQUE_IDENTIFIER\n");
-
-		}
-		else {
-			infodata += "ServerUID = ";
-			infodata += buffer;// copy the VIRTUALSERVER_UNIQUE_IDENTIFIER into infodata
-			infodata += "\n";// copy a return into infodata
-
-
-		}
-
-
-		//VIRTUALSERVER_ID
-		//ts3Functions.requestServerVariables(serverConnectionHandlerID);
-
-		if (ts3Functions.getServerVariableAsUInt64(serverConnectionHandlerID, VIRTUALSERVER_ID, &bufferUInt) != ERROR_ok) {
-			printf("Error getting VIRTUALSERVER_ID\n");
-
-		}
-
-		else {
-
-			infodata += "Virtualserver ID = ";
-			infodata += convertoString<uint64>(bufferUInt);// copy the VIRTUALSERVER_ID into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-
-		//CONNECTION_INFO
-		if (ts3Functions.requestConnectionInfo(serverConnectionHandlerID, myid, NULL) != ERROR_ok) {
-			printf("Error getting ConnectionInfo\n");
-
-		}
-
-		if (ts3Functions.getConnectionVariableAsString(serverConnectionHandlerID, myid, CONNECTION_SERVER_IP, &buffer) != ERROR_ok) {
-			printf("Error getting Connection Server IP\n");
-		}
-
-		else {
-			infodata += "Serverip = ";
-			infodata += buffer; // copy the Serverip into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-
-		//port
-		if (ts3Functions.getServerVariableAsInt(serverConnectionHandlerID, VIRTUALSERVER_PORT, &bufferInt) != ERROR_ok) {
-			printf("Error getting Virtualserver Port\n");
-
-		}
-		else {
-			infodata += "Virtualserver Port = ";
-			infodata += convertoString<int>(bufferInt);// copy the VIRTUALSERVER_PORT into infodata
-			//infodata += "\n";// copy a return into infodata
-		}
-		break;
-	}
-	case PLUGIN_CHANNEL: {
-		//channelid
-		infodata += "Channel ID = ";
-		infodata += convertoString<uint64>(id); // copy the ChannelID into infodata
-		infodata += "\n";// copy a return into infodata
-
-
-		//channelOrderID
-
-		if (ts3Functions.getChannelVariableAsUInt64(serverConnectionHandlerID, id, CHANNEL_ORDER, &bufferUInt) != ERROR_ok) {
-			printf("Error getting CHANNEL ORDER ID \n");
-
-		}
-		else {
-			infodata += "Order ID = ";
-			infodata += convertoString<uint64>(bufferUInt);// copy the CHANNEL_ORDER into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-
-		//pheotischername
-
-		if (ts3Functions.getChannelVariableAsString(serverConnectionHandlerID, id, CHANNEL_NAME_PHONETIC, &buffer) != ERROR_ok) {
-			printf("Error getting CHANNEL_NAME_PHONETIC\n");
-
-		}
-
-		else {
-			infodata += "Phoetic Channelname = ";
-			infodata += buffer;// copy the CHANNEL_NAME_PHONETIC into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		/*
-		//channelcodec
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_CODEC_QUALITY, &bufferInt) != ERROR_ok) {
-			printf("Error getting Channel Code\n");
-		}
-		else {
-			infodata += "Channel Codec = ";
-			infodata += getChannelCodec(bufferInt);// copy the Channel Codec into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}*/
-
-		//channelcodec qualitt
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_CODEC_QUALITY, &bufferInt) != ERROR_ok) {
-			printf("Error getting Codec Quality\n");
-		}
-		else {
-			infodata += "Codec Quality = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-
-		//CHANNEL_FLAG_PERMANENT
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_PERMANENT, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_PERMANENT\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_PERMANENT = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-		//CHANNEL_FLAG_SEMI_PERMANENT
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_SEMI_PERMANENT, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_SEMI_PERMANENT\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_SEMI_PERMANENT = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-		//CHANNEL_FLAG_DEFAULT
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_DEFAULT, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_DEFAULT\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_DEFAULT = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FLAG_PASSWORD
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_PASSWORD, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_PASSWORD\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_PASSWORD = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_CODEC_LATENCY_FACTOR
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_CODEC_LATENCY_FACTOR, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_CODEC_LATENCY_FACTOR\n");
-		}
-		else {
-			infodata += "CHANNEL_CODEC_LATENCY_FACTOR = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_CODEC_IS_UNENCRYPTED
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_CODEC_IS_UNENCRYPTED, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_CODEC_IS_UNENCRYPTED\n");
-		}
-		else {
-			infodata += "CHANNEL_CODEC_IS_UNENCRYPTED = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_DELETE_DELAY
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_DELETE_DELAY, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_DELETE_DELAY\n");
-		}
-		else {
-			infodata += "CHANNEL_DELETE_DELAY = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FLAG_MAXCLIENTS_UNLIMITED
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_MAXCLIENTS_UNLIMITED, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_MAXCLIENTS_UNLIMITED\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_MAXCLIENTS_UNLIMITED = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FLAG_MAXFAMILYCLIENTS_UNLIMITED
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_MAXFAMILYCLIENTS_UNLIMITED, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_MAXFAMILYCLIENTS_UNLIMITED\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_MAXFAMILYCLIENTS_UNLIMITED = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FLAG_MAXFAMILYCLIENTS_INHERITED
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_MAXFAMILYCLIENTS_INHERITED, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_MAXFAMILYCLIENTS_INHERITED\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_MAXFAMILYCLIENTS_INHERITED = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FLAG_ARE_SUBSCRIBED
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_ARE_SUBSCRIBED, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_ARE_SUBSCRIBED\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_ARE_SUBSCRIBED = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_NEEDED_TALK_POWER
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_NEEDED_TALK_POWER, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_NEEDED_TALK_POWER\n");
-		}
-		else {
-			infodata += "CHANNEL_NEEDED_TALK_POWER = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FORCED_SILENCE
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FORCED_SILENCE, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FORCED_SILENCE\n");
-		}
-		else {
-			infodata += "CHANNEL_FORCED_SILENCE = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_ICON_ID
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_ICON_ID, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_ICON_ID\n");
-		}
-		else {
-			infodata += "CHANNEL_ICON_ID = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CHANNEL_FLAG_PRIVATE
-		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, CHANNEL_FLAG_PRIVATE, &bufferInt) != ERROR_ok) {
-			printf("Error getting CHANNEL_FLAG_PRIVATE\n");
-		}
-		else {
-			infodata += "CHANNEL_FLAG_PRIVATE = ";
-			infodata += convertoString<int>(bufferInt);// copy the Codec Quality into infodata
-			//infodata += "\n";// copy a return into infodata
-		}
-
-		break;
-	}
-	case PLUGIN_CLIENT: {
-		//ConnectionInfo
-
-		if (ts3Functions.requestConnectionInfo(serverConnectionHandlerID, (anyID)id, NULL) != ERROR_ok) {
-			printf("Error getting ConnectionInfo\n");
-
-		}
-
-		// Client data
-		//ClientID
-
-		infodata += "Client ID = ";
-		infodata += convertoString<uint64>(id);// copy the ClientID into infodata
-		infodata += "\n";// copy a return into infodata
-
-		//CLIENT_UNIQUE_IDENTIFIER
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_UNIQUE_IDENTIFIER, &buffer) != ERROR_ok) {
-			printf("Error getting client UID\n");
-
-		}
-		else {
-			infodata += "UID = ";
-			infodata += buffer;// copy the UID into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//clientdatabaseID
-		if (ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, (anyID)id, CLIENT_DATABASE_ID, &bufferInt) != ERROR_ok) {
-			printf("Error getting client DatabaseID\n");
-
-		}
-		else {
-			infodata += "DBID = ";
-			infodata += convertoString<int>(bufferInt);// copy the DBID into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-
-
-		//ClientServergroups
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_SERVERGROUPS, &buffer) != ERROR_ok) {
-			printf("Error getting client Servergroups\n");
-		}
-		else {
-
-			infodata += "ServerGroups = ";
-			infodata += buffer;// copy the servergroupids into infodata
-			infodata += "\n";// copy a return into infodata
-
-		}
-
-
-		//totalConnections
-		if (ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, (anyID)id, CLIENT_TOTALCONNECTIONS, &bufferInt) != ERROR_ok) {
-			printf("Error getting client TOTALCONNECTIONS\n");
-
-		}
-		else {
-			infodata += "Total Connections = ";
-			infodata += convertoString<int>(bufferInt);// copy the totalconnections into infodata
-			infodata += "\n";// copy a return into infodata						
-		}
-
-
-		//Ping
-		Sleep(115);
-		if (ts3Functions.getConnectionVariableAsDouble(serverConnectionHandlerID, (anyID)id, CONNECTION_PING, &bufferD) != ERROR_ok) {
-			printf("Error getting client Ping\n");
-		}
-
-		else {
-
-
-			infodata += "Ping = ";
-			infodata += convertoString<int>((int)bufferD); // cast to int to lost .00000   copy the PING into infodata
-			infodata += "\n";// copy a return into infodata	
-		}
-
-
-		//pheotischername
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_NICKNAME_PHONETIC, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_NICKNAME_PHONETIC\n");
-		
-		}
-		infodata += "Phonetic Nickname = ";
-		infodata += buffer;// copy the Client phonetic Nickname into infodata
-		infodata += "\n";// copy a return into infodata	
-
-	//version sign
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_VERSION_SIGN, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_VERSION_SIGN\n");
-		
-		}
-		else {
-			infodata += "Client Version Sign = ";
-			infodata += buffer;// copy the Client version sign into infodata	
-			infodata += "\n";// copy a return into infodata	
-		}
-	//badgetid
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_BADGES, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_BADGES\n");
-		
-		}
-		else {
-			infodata += "Client BadgetIDs = ";
-			infodata += buffer;// copy the CLIENT_BADGES into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		 //CLIENT_FLAG_TALKING
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_FLAG_TALKING, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_FLAG_TALKING\n");
-		
-		}
-		else {
-			infodata += "CLIENT_FLAG_TALKING = ";
-			infodata += buffer;// copy the CLIENT_FLAG_TALKING into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		 //CLIENT_INPUT_MUTED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_INPUT_MUTED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_INPUT_MUTED\n");
-		
-		}
-		else {
-			infodata += "CLIENT_INPUT_MUTED = ";
-			infodata += buffer;// copy the CLIENT_INPUT_MUTED into infodata
-			infodata += "\n";// copy a return into infodata	
-		}
-
-		//CLIENT_OUTPUT_MUTED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_OUTPUT_MUTED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_OUTPUT_MUTED\n");
-		
-		}
-		else {
-			infodata += "CLIENT_OUTPUT_MUTED = ";
-			infodata += buffer;// copy the CLIENT_OUTPUT_MUTED into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CLIENT_OUTPUTONLY_MUTED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_OUTPUTONLY_MUTED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_OUTPUTONLY_MUTED\n");
-		
-		}
-		else {
-			infodata += "CLIENT_OUTPUTONLY_MUTED = ";
-			infodata += buffer;// copy the CLIENT_OUTPUTONLY_MUTED into infodata
-			infodata += "\n";// copy a return into infodata
-		}
-		//CLIENT_INPUT_HARDWARE
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_INPUT_HARDWARE, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_INPUT_HARDWARE\n");
-			
-		}
-		else {
-			infodata += "CLIENT_INPUT_HARDWARE = ";
-			infodata += buffer;// copy the CLIENT_INPUT_HARDWARE into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_OUTPUT_HARDWARE
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_OUTPUT_HARDWARE, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_OUTPUT_HARDWARE\n");
-			
-		}
-		else {
-			infodata += "CLIENT_OUTPUT_HARDWARE = ";
-			infodata += buffer;// copy the CLIENT_OUTPUT_HARDWARE into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		 //CLIENT_IS_RECORDING
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_IS_RECORDING, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_IS_RECORDING\n");
-			
-		}
-		else {
-			infodata += "CLIENT_IS_RECORDING = ";
-			infodata += buffer;// copy the CLIENT_IS_RECORDING into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_CHANNEL_GROUP_ID
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_CHANNEL_GROUP_ID, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_CHANNEL_GROUP_ID\n");
-			
-		}
-		else {
-			infodata += "CLIENT_CHANNEL_GROUP_ID = ";
-			infodata += buffer;// copy the CLIENT_CHANNEL_GROUP_ID into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		
-		//CLIENT_CREATED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_CREATED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_CREATED\n");
-			
-		}
-		else {
-			infodata += "CLIENT_CREATED = ";
-			infodata += buffer;// copy the CLIENT_CREATED into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-
-		//CLIENT_LASTCONNECTED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_LASTCONNECTED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_LASTCONNECTED\n");
-
-		}
-		else {
-			infodata += "CLIENT_LASTCONNECTED = ";
-			infodata += buffer;// copy the CLIENT_LASTCONNECTED into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_AWAY
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_AWAY, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_AWAY\n");
-
-		}
-		else {
-			infodata += "CLIENT_AWAY = ";
-			infodata += buffer;// copy the CLIENT_AWAY into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_AWAY_MESSAGE
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_AWAY_MESSAGE, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_AWAY_MESSAGE\n");
-
-		}
-		else {
-			infodata += "CLIENT_AWAY_MESSAGE = ";
-			infodata += buffer;// copy the CLIENT_AWAY_MESSAGE into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_TYPE
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_TYPE, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_TYPE\n");
-
-		}
-		else {
-			infodata += "CLIENT_TYPE = ";
-			infodata += buffer;// copy the CLIENT_TYPE into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_FLAG_AVATAR
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_FLAG_AVATAR, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_FLAG_AVATAR\n");
-
-		}
-		else {
-			infodata += "CLIENT_FLAG_AVATAR = ";
-			infodata += buffer;// copy the CLIENT_FLAG_AVATAR into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_TALK_POWER
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_TALK_POWER, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_TALK_POWER\n");
-
-		}
-		else {
-			infodata += "CLIENT_TALK_POWER = ";
-			infodata += buffer;// copy the CLIENT_TALK_POWER into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_IS_TALKER
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_IS_TALKER, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_IS_TALKER\n");
-
-		}
-		else {
-			infodata += "CLIENT_IS_TALKER = ";
-			infodata += buffer;// copy the CLIENT_IS_TALKER into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_MONTH_BYTES_UPLOADED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_MONTH_BYTES_UPLOADED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_MONTH_BYTES_UPLOADED\n");
-
-		}
-		else {
-			infodata += "CLIENT_MONTH_BYTES_UPLOADED = ";
-			infodata += buffer;// copy the CLIENT_MONTH_BYTES_UPLOADED into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_MONTH_BYTES_DOWNLOADED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_MONTH_BYTES_DOWNLOADED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_MONTH_BYTES_DOWNLOADED\n");
-
-		}
-		else {
-			infodata += "CLIENT_MONTH_BYTES_DOWNLOADED = ";
-			infodata += buffer;// copy the CLIENT_MONTH_BYTES_DOWNLOADED into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_TOTAL_BYTES_UPLOADED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_TOTAL_BYTES_UPLOADED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_TOTAL_BYTES_UPLOADED\n");
-
-		}
-		else {
-			infodata += "CLIENT_TOTAL_BYTES_UPLOADED = ";
-			infodata += buffer;// copy the CLIENT_TOTAL_BYTES_UPLOADED into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_TOTAL_BYTES_DOWNLOADED
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_TOTAL_BYTES_DOWNLOADED, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_TOTAL_BYTES_DOWNLOADED\n");
-
-		}
-		else {
-			infodata += "CLIENT_TOTAL_BYTES_DOWNLOADED = ";
-			infodata += buffer;// copy the CLIENT_TOTAL_BYTES_DOWNLOADED into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_IS_PRIORITY_SPEAKER
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_IS_PRIORITY_SPEAKER, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_IS_PRIORITY_SPEAKER\n");
-
-		}
-		else {
-			infodata += "CLIENT_IS_PRIORITY_SPEAKER = ";
-			infodata += buffer;// copy the CLIENT_IS_PRIORITY_SPEAKER into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_UNREAD_MESSAGES
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_UNREAD_MESSAGES, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_UNREAD_MESSAGES\n");
-
-		}
-		else {
-			infodata += "CLIENT_UNREAD_MESSAGES = ";
-			infodata += buffer;// copy the CLIENT_UNREAD_MESSAGES into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_NEEDED_SERVERQUERY_VIEW_POWER
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_NEEDED_SERVERQUERY_VIEW_POWER, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_NEEDED_SERVERQUERY_VIEW_POWER\n");
-
-		}
-		else {
-			infodata += "CLIENT_NEEDED_SERVERQUERY_VIEW_POWER = ";
-			infodata += buffer;// copy the CLIENT_NEEDED_SERVERQUERY_VIEW_POWER into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_ICON_ID
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_ICON_ID, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_ICON_ID\n");
-
-		}
-		else {
-			infodata += "CLIENT_ICON_ID = ";
-			infodata += buffer;// copy the CLIENT_ICON_ID into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_IS_CHANNEL_COMMANDER
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_IS_CHANNEL_COMMANDER, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_IS_CHANNEL_COMMANDER\n");
-
-		}
-		else {
-			infodata += "CLIENT_IS_CHANNEL_COMMANDER = ";
-			infodata += buffer;// copy the CLIENT_IS_CHANNEL_COMMANDER into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_COUNTRY
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_COUNTRY, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_COUNTRY\n");
-
-		}
-		else {
-			infodata += "CLIENT_COUNTRY = ";
-			infodata += buffer;// copy the CLIENT_COUNTRY into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-		//CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID\n");
-
-		}
-		else {
-			infodata += "CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID = ";
-			infodata += buffer;// copy the CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID into infodata
-			infodata += "\n";// copy a return into infodat
-		}
-
-		//meta data
-		if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, CLIENT_META_DATA, &buffer) != ERROR_ok) {
-			printf("Error getting CLIENT_META_DATA\n");
-			
-		}
-		else {
-			infodata += "Client metadata = ";
-			infodata += buffer; // copy a the CLIENT_CLIENT_META_DATA into infodata
-			//infodata += "\n";// copy a return into infodata
-		}
-		break;
-	}
-		default:
-			printf("Invalid item type: %d\n", type);
-			data = NULL;  /* Ignore */
-			return;
-	}
-	/* Must be allocated in the plugin! */
-	*data = (char*)malloc((infodata.length() + 1)* sizeof(char));
-	snprintf(*data, (infodata.length() + 1), infodata.c_str());
-}
-
-/* Required to release the memory for parameter "data" allocated in ts3plugin_infoData and ts3plugin_initMenus */
-void ts3plugin_freeMemory(void* data) {
-	free(data);
-}
-
-/*
- * Plugin requests to be always automatically loaded by the TeamSpeak 3 client unless
- * the user manually disabled it in the plugin dialog.
- * This function is optional. If missing, no autoload is assumed.
- */
-int ts3plugin_requestAutoload() {
-	return 0;  /* 1 = request autoloaded, 0 = do not request autoload */
-}
-
-/* Helper function to create a menu item */
-static struct PluginMenuItem* createMenuItem(enum PluginMenuType type, int id, const char* text, const char* icon) {
-	struct PluginMenuItem* menuItem = (struct PluginMenuItem*)malloc(sizeof(struct PluginMenuItem));
-	menuItem->type = type;
-	menuItem->id = id;
-	_strcpy(menuItem->text, PLUGIN_MENU_BUFSZ, text);
-	_strcpy(menuItem->icon, PLUGIN_MENU_BUFSZ, icon);
-	return menuItem;
-}
-
-/* Some makros to make the code to create menu items a bit more readable */
-#define BEGIN_CREATE_MENUS(x) const size_t sz = x + 1; size_t n = 0; *menuItems = (struct PluginMenuItem**)malloc(sizeof(struct PluginMenuItem*) * sz);
-#define CREATE_MENU_ITEM(a, b, c, d) (*menuItems)[n++] = createMenuItem(a, b, c, d);
-#define END_CREATE_MENUS (*menuItems)[n++] = NULL; assert(n == sz);
-
-
-
-/*
- * Initialize plugin menus.
- * This function is called after ts3plugin_init and ts3plugin_registerPluginID. A pluginID is required for plugin menus to work.
- * Both ts3plugin_registerPluginID and ts3plugin_freeMemory must be implemented to use menus.
- * If plugin menus are not used by a plugin, do not implement this function or return NULL.
- */
-void ts3plugin_initMenus(struct PluginMenuItem*** menuItems, char** menuIcon) {
-	/*
-	 * Create the menus
-	 * There are three types of menu items:
-	 * - PLUGIN_MENU_TYPE_CLIENT:  Client context menu
-	 * - PLUGIN_MENU_TYPE_CHANNEL: Channel context menu
-	 * - PLUGIN_MENU_TYPE_GLOBAL:  "Plugins" menu in menu bar of main window
-	 *
-	 * Menu IDs are used to identify the menu item when ts3plugin_onMenuItemEvent is called
-	 *
-	 * The menu text is required, max length is 128 characters
-	 *
-	 * The icon is optional, max length is 128 characters. When not using icons, just pass an empty string.
-	 * Icons are loaded from a subdirectory in the TeamSpeak client plugins folder. The subdirectory must be named like the
-	 * plugin filename, without dll/so/dylib suffix
-	 * e.g. for "test_plugin.dll", icon "1.png" is loaded from <TeamSpeak 3 Client install dir>\plugins\test_plugin\1.png
-	 */
-
-	BEGIN_CREATE_MENUS(0);  /* IMPORTANT: Number of menu items must be correct! */
-	END_CREATE_MENUS;  /* Includes an assert checking if the number of menu items matched */
-
-	/*
-	 * Specify an optional icon for the plugin. This icon is used for the plugins submenu within context and main menus
-	 * If unused, set menuIcon to NULL
-	 */
-	*menuIcon = (char*)malloc(PLUGIN_MENU_BUFSZ * sizeof(char));
-	_strcpy(*menuIcon, PLUGIN_MENU_BUFSZ, "t.png");
-
-	/*
-	 * Menus can be enabled or disabled with: ts3Functions.setPluginMenuEnabled(pluginID, menuID, 0|1);
-	 * Test it with plugin command: /test enablemenu <menuID> <0|1>
-	 * Menus are enabled by default. Please note that shown menus will not automatically enable or disable when calling this function to
-	 * ensure Qt menus are not modified by any thread other the UI thread. The enabled or disable state will change the next time a
-	 * menu is displayed.
-	 */
-	/* For example, this would disable MENU_ID_GLOBAL_2: */
-	/* ts3Functions.setPluginMenuEnabled(pluginID, MENU_ID_GLOBAL_2, 0); */
-
-	/* All memory allocated in this function will be automatically released by the TeamSpeak client later by calling ts3plugin_freeMemory */
-}
-
-/* Helper function to create a hotkey */
-static struct PluginHotkey* createHotkey(const char* keyword, const char* description) {
-	struct PluginHotkey* hotkey = (struct PluginHotkey*)malloc(sizeof(struct PluginHotkey));
-	_strcpy(hotkey->keyword, PLUGIN_HOTKEY_BUFSZ, keyword);
-	_strcpy(hotkey->description, PLUGIN_HOTKEY_BUFSZ, description);
-	return hotkey;
-}
-
-/* Some makros to make the code to create hotkeys a bit more readable */
-#define BEGIN_CREATE_HOTKEYS(x) const size_t sz = x + 1; size_t n = 0; *hotkeys = (struct PluginHotkey**)malloc(sizeof(struct PluginHotkey*) * sz);
-#define CREATE_HOTKEY(a, b) (*hotkeys)[n++] = createHotkey(a, b);
-#define END_CREATE_HOTKEYS (*hotkeys)[n++] = NULL; assert(n == sz);
-
-/*
- * Initialize plugin hotkeys. If your plugin does not use this feature, this function can be omitted.
- * Hotkeys require ts3plugin_registerPluginID and ts3plugin_freeMemory to be implemented.
- * This function is automatically called by the client after ts3plugin_init.
- */
-void ts3plugin_initHotkeys(struct PluginHotkey*** hotkeys) {
-	/* Register hotkeys giving a keyword and a description.
-	 * The keyword will be later passed to ts3plugin_onHotkeyEvent to identify which hotkey was triggered.
-	 * The description is shown in the clients hotkey dialog. */
-	BEGIN_CREATE_HOTKEYS(0);  /* Create 3 hotkeys. Size must be correct for allocating memory. */
-	END_CREATE_HOTKEYS;
-
-	/* The client will call ts3plugin_freeMemory to release all allocated memory */
-}
-
+/*
+ * TeamSpeak 3 demo plugin
+ *
+ * Copyright (c) 2008-2016 TeamSpeak Systems GmbH
+ */
+
+#ifdef _WIN32
+#pragma warning (disable : 4100)  /* Disable Unreferenced parameter warning */
+#include <Windows.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "teamspeak/public_errors.h"
+#include "teamspeak/public_errors_rare.h"
+#include "teamspeak/public_definitions.h"
+#include "teamspeak/public_rare_definitions.h"
+#include "teamspeak/clientlib_publicdefinitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "infoformat.h"
+#include "profiles.h"
+#include "world.h"
+#include "stringpool.h"
+#include "namecache.h"
+#include "talktime.h"
+#include "requests.h"
+#include "eventqueue.h"
+#include "journal.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <charconv>
+
+static struct TS3Functions ts3Functions;
+
+#ifdef _WIN32
+#define _strcpy(dest, destSize, src) strcpy_s(dest, destSize, src)
+#define snprintf sprintf_s
+#else
+#define _strcpy(dest, destSize, src) { strncpy(dest, src, destSize-1); (dest)[destSize-1] = '\0'; }
+#endif
+
+#define PLUGIN_API_VERSION 23
+#define PLUGIN_VERSION "1"
+
+#define PATH_BUFSIZE 512
+#define COMMAND_MAX_WORDS 3
+#define INFODATA_BUFSIZE 7000
+#define INFODATA_MAX_BUFSIZE (64 * INFODATA_BUFSIZE)  /* Longer texts are cut */
+#define SERVERINFO_BUFSIZE 256
+#define CHANNELINFO_BUFSIZE 512
+#define RETURNCODE_BUFSIZE 128
+
+static char* pluginID = NULL;
+static std::atomic<bool> returnCodesEnabled(false);  /* pluginID is set, requests carry return codes */
+
+/*
+ * Owns a buffer returned by the client library (variable strings, client and channel lists) and releases it with
+ * ts3Functions.freeMemory. Pass out() to the getter, it drops the previously held buffer.
+ */
+template <typename T>
+class LibraryBuffer {
+public:
+	LibraryBuffer() : pointer(NULL) {}
+	explicit LibraryBuffer(T* p) : pointer(p) {}
+	LibraryBuffer(LibraryBuffer&& other) : pointer(other.pointer) { other.pointer = NULL; }
+	~LibraryBuffer() { reset(); }
+
+	LibraryBuffer& operator=(LibraryBuffer&& other) {
+		if (this != &other) {
+			reset();
+			pointer = other.pointer;
+			other.pointer = NULL;
+		}
+		return *this;
+	}
+
+	LibraryBuffer(const LibraryBuffer&) = delete;
+	LibraryBuffer& operator=(const LibraryBuffer&) = delete;
+
+	T* get() const { return pointer; }
+	T** out() { reset(); return &pointer; }
+
+	void reset() {
+		if (pointer) {
+			ts3Functions.freeMemory(pointer);
+			pointer = NULL;
+		}
+	}
+
+private:
+	T* pointer;
+};
+
+typedef LibraryBuffer<char> LibraryString;
+
+#ifdef _WIN32
+/* Helper function to convert wchar_T to Utf-8 encoded strings on Windows */
+static int wcharToUtf8(const wchar_t* str, char** result) {
+	int outlen = WideCharToMultiByte(CP_UTF8, 0, str, -1, 0, 0, 0, 0);
+	*result = (char*)malloc(outlen);
+	if(WideCharToMultiByte(CP_UTF8, 0, str, -1, *result, outlen, 0, 0) == 0) {
+		*result = NULL;
+		return -1;
+	}
+	return 0;
+}
+#endif
+
+/* Field profiles, implemented next to the info field tables */
+static void loadProfiles(const char* configPath);
+static void reloadProfiles();
+static void printProfiles();
+static void selectProfile(const char* name);
+
+/* Server connection shards, implemented next to the per connection caches */
+static void openEstablishedShards();
+static void closeAllShards();
+
+/* Name caches, implemented next to the shards */
+static void openNameCaches(const char* configPath);
+static void closeNameCaches();
+static void whois(uint64 serverConnectionHandlerID, const char* key);
+
+/* Server requests, implemented next to the name caches */
+static void scheduleRequest(struct ServerShard* shard, enum RequestCommand command, uint64 id, bool urgent);
+static void printRequestCounters(uint64 serverConnectionHandlerID);
+static void limitRequests(double rate, unsigned int burst);
+
+/* Event worker, implemented next to the callbacks feeding it */
+static void startEventWorker(const char* configPath);
+static void stopEventWorker();
+static void postConnected(uint64 serverConnectionHandlerID);
+
+/*********************************** Required functions ************************************/
+/*
+ * If any of these required functions is not implemented, TS3 will refuse to load the plugin
+ */
+
+/* Unique name identifying this plugin */
+const char* ts3plugin_name() {
+#ifdef _WIN32
+	/* TeamSpeak expects UTF-8 encoded characters. Following demonstrates a possibility how to convert UTF-16 wchar_t into UTF-8. */
+	static char* result = NULL;  /* Static variable so it's allocated only once */
+	if(!result) {
+		const wchar_t* name = L"Too Much Informations";
+		if(wcharToUtf8(name, &result) == -1) {  /* Convert name into UTF-8 encoded result */
+			result = "Too Much Informations";  /* Conversion failed, fallback here */
+		}
+	}
+	return result;
+#else
+	return "Too Much Informations";
+#endif
+}
+
+/* Plugin version */
+const char* ts3plugin_version() {
+    return PLUGIN_VERSION;
+}
+
+/* Plugin API version. Must be the same as the clients API major version, else the plugin fails to load. */
+int ts3plugin_apiVersion() {
+	return PLUGIN_API_VERSION;
+}
+
+/* Plugin author */
+const char* ts3plugin_author() {
+	/* If you want to use wchar_t, see ts3plugin_name() on how to use */
+    return "shitty720";
+}
+
+/* Plugin description */
+const char* ts3plugin_description() {
+	/* If you want to use wchar_t, see ts3plugin_name() on how to use */
+    return "Too Much Informations";
+}
+
+/* Set TeamSpeak 3 callback functions */
+void ts3plugin_setFunctionPointers(const struct TS3Functions funcs) {
+    ts3Functions = funcs;
+}
+
+/*
+ * Custom code called right after loading the plugin. Returns 0 on success, 1 on failure.
+ * If the function returns 1 on failure, the plugin will be unloaded again.
+ */
+int ts3plugin_init() {
+    char appPath[PATH_BUFSIZE];
+    char resourcesPath[PATH_BUFSIZE];
+    char configPath[PATH_BUFSIZE];
+	char pluginPath[PATH_BUFSIZE];
+
+    /* Your plugin init code here */
+    printf("client user data: init\n");
+
+    /* Example on how to query application, resources and configuration paths from client */
+    /* Note: Console client returns empty string for app and resources path */
+    ts3Functions.getAppPath(appPath, PATH_BUFSIZE);
+    ts3Functions.getResourcesPath(resourcesPath, PATH_BUFSIZE);
+    ts3Functions.getConfigPath(configPath, PATH_BUFSIZE);
+	ts3Functions.getPluginPath(pluginPath, PATH_BUFSIZE);
+
+	loadProfiles(configPath);
+	openEstablishedShards();
+	openNameCaches(configPath);
+	startEventWorker(configPath);
+
+	//printf("PLUGIN: App path: %s\nResources path: %s\nConfig path: %s\nPlugin path: %s\n", appPath, resourcesPath, configPath, pluginPath);
+
+    return 0;  /* 0 = success, 1 = failure, -2 = failure but client will not show a "failed to load" warning */
+	/* -2 is a very special case and should only be used if a plugin displays a dialog (e.g. overlay) asking the user to disable
+	 * the plugin again, avoiding the show another dialog by the client telling the user the plugin failed to load.
+	 * For normal case, if a plugin really failed to load because of an error, the correct return value is 1. */
+}
+
+/* Custom code called right before the plugin is unloaded */
+void ts3plugin_shutdown() {
+    /* Your plugin cleanup code here */
+    printf("client user data: shutdown\n");
+
+	/*
+	 * Note:
+	 * If your plugin implements a settings dialog, it must be closed and deleted here, else the
+	 * TeamSpeak client will most likely crash (DLL removed but dialog from DLL code still open).
+	 */
+
+	stopEventWorker();
+	closeAllShards();
+	closeNameCaches();
+
+	/* Free pluginID if we registered it, requests are no longer sent */
+	returnCodesEnabled = false;
+	if(pluginID) {
+		free(pluginID);
+		pluginID = NULL;
+	}
+}
+
+/****************************** Optional functions ********************************/
+/*
+ * Following functions are optional, if not needed you don't need to implement them.
+ */
+
+/* Tell client if plugin offers a configuration window. If this function is not implemented, it's an assumed "does not offer" (PLUGIN_OFFERS_NO_CONFIGURE). */
+int ts3plugin_offersConfigure() {
+	//printf("PLUGIN: offersConfigure\n");
+	/*
+	 * Return values:
+	 * PLUGIN_OFFERS_NO_CONFIGURE         - Plugin does not implement ts3plugin_configure
+	 * PLUGIN_OFFERS_CONFIGURE_NEW_THREAD - Plugin does implement ts3plugin_configure and requests to run this function in an own thread
+	 * PLUGIN_OFFERS_CONFIGURE_QT_THREAD  - Plugin does implement ts3plugin_configure and requests to run this function in the Qt GUI thread
+	 */
+	return PLUGIN_OFFERS_NO_CONFIGURE;  /* In this case ts3plugin_configure does not need to be implemented */
+}
+
+/* Plugin might offer a configuration window. If ts3plugin_offersConfigure returns 0, this function does not need to be implemented. */
+void ts3plugin_configure(void* handle, void* qParentWidget) {
+   // printf("PLUGIN: configure\n");
+}
+
+/*
+ * If the plugin wants to use error return codes, plugin commands, hotkeys or menu items, it needs to register a command ID. This function will be
+ * automatically called after the plugin was initialized. This function is optional. If you don't use these features, this function can be omitted.
+ * Note the passed pluginID parameter is no longer valid after calling this function, so you must copy it and store it in the plugin.
+ */
+void ts3plugin_registerPluginID(const char* id) {
+	const size_t sz = strlen(id) + 1;
+	pluginID = (char*)malloc(sz * sizeof(char));
+	_strcpy(pluginID, sz, id);  /* The id buffer will invalidate after exiting this function */
+	returnCodesEnabled = true;
+	//printf("PLUGIN: registerPluginID: %s\n", pluginID);
+}
+
+/* Plugin command keyword. Return NULL or "" if not used. */
+const char* ts3plugin_commandKeyword() {
+	return "informations";
+}
+
+/* Split a command at blanks, returns the number of words, maxWords + 1 if there are more than maxWords */
+static size_t splitCommand(const char* command, std::string* words, size_t maxWords) {
+	size_t count = 0;
+	while (*command) {
+		if (*command == ' ' || *command == '\t') {
+			++command;
+			continue;
+		}
+		const char* end = command;
+		while (*end && *end != ' ' && *end != '\t') {
+			++end;
+		}
+		if (count == maxWords) {
+			return maxWords + 1;
+		}
+		words[count++].assign(command, end);
+		command = end;
+	}
+	return count;
+}
+
+/* A number taking the whole word */
+template<typename T> static bool parseNumber(const std::string& word, T* value) {
+	const char* end = word.data() + word.length();
+	const std::from_chars_result result = std::from_chars(word.data(), end, *value);
+	return result.ec == std::errc() && result.ptr == end;
+}
+
+/* Plugin processes console command. Return 0 if plugin handled the command, 1 if not handled. */
+int ts3plugin_processCommand(uint64 serverConnectionHandlerID, const char* command) {
+	std::string words[COMMAND_MAX_WORDS];
+	const size_t count = splitCommand(command, words, COMMAND_MAX_WORDS);
+	double rate;
+	unsigned int burst;
+
+	if (count == 1 && words[0] == "profile") {
+		printProfiles();
+	}
+	else if (count == 2 && words[0] == "profile") {
+		selectProfile(words[1].c_str());
+	}
+	else if (count == 1 && words[0] == "reload") {
+		reloadProfiles();
+	}
+	else if (count == 2 && words[0] == "whois") {
+		whois(serverConnectionHandlerID, words[1].c_str());
+	}
+	else if (count == 1 && words[0] == "requests") {
+		printRequestCounters(serverConnectionHandlerID);
+	}
+	else if (count == 3 && words[0] == "ratelimit" && parseNumber(words[1], &rate) && parseNumber(words[2], &burst)) {
+		limitRequests(rate, burst);
+	}
+	else {
+		ts3Functions.printMessageToCurrentTab("Usage: /informations profile [<name>] | reload | whois <UID or database ID> | requests | "
+		                                      "ratelimit <requests per second> <burst>");
+	}
+	return 0;  /* Plugin handled command */
+}
+
+/* Client changed current server connection handler */
+void ts3plugin_currentServerConnectionChanged(uint64 serverConnectionHandlerID) {
+    printf("PLUGIN: currentServerConnectionChanged %llu (%llu)\n", (long long unsigned int)serverConnectionHandlerID, (long long unsigned int)ts3Functions.getCurrentServerConnectionHandlerID());
+}
+
+/*
+ * Implement the following three functions when the plugin should display a line in the server/channel/client info.
+ * If any of ts3plugin_infoTitle, ts3plugin_infoData or ts3plugin_freeMemory is missing, the info text will not be displayed.
+ */
+
+/* Static title shown in the left column in the info frame */
+const char* ts3plugin_infoTitle() {
+	return "Informations";
+}
+
+/*
+ * Dynamic content shown in the right column in the info frame. Memory for the data string needs to be allocated in this
+ * function. The client will call ts3plugin_freeMemory once done with the string to release the allocated memory again.
+ * Check the parameter "type" if you want to implement this feature only for specific item types. Set the parameter
+ * "data" to NULL to have the client ignore the info data.
+ */
+
+std::string getChannelCodec(int a) {
+
+	switch (a) {
+	case CODEC_SPEEX_NARROWBAND:
+		return std::string("CODEC_SPEEX_NARROWBAND");
+		break;
+	case CODEC_SPEEX_WIDEBAND:
+		return std::string("CODEC_SPEEX_WIDEBAND");
+		break;
+	case CODEC_SPEEX_ULTRAWIDEBAND:
+		return std::string("CODEC_SPEEX_ULTRAWIDEBAND");
+		break;
+	case CODEC_CELT_MONO:
+		return std::string("CODEC_CELT_MONO");
+		break;
+	case CODEC_OPUS_VOICE:
+		return std::string("CODEC_OPUS_VOICE");
+		break;
+	case CODEC_OPUS_MUSIC:
+		return std::string("CODEC_OPUS_MUSIC");
+		break;
+	default:
+		return std::string("error");
+		break;
+	}
+}
+
+/* Formatters of info field values, picked at compile time by the field tables */
+static void writeValue(TextWriter* out, const int& value) {
+	out->appendNumber(value);
+}
+
+static void writeValue(TextWriter* out, const uint64& value) {
+	out->appendNumber(value);
+}
+
+static void writeValue(TextWriter* out, const std::string& value) {
+	out->append(value.data(), value.length());
+}
+
+static void writeBytes(TextWriter* out, const uint64& value) {
+	out->appendBytes(value);
+}
+
+static void writeDate(TextWriter* out, const uint64& value) {
+	out->appendDate(value);
+}
+
+/* Date followed by the time passed since then */
+static void writeDateAge(TextWriter* out, const uint64& value) {
+	out->appendDate(value);
+	const uint64 now = (uint64)time(NULL);
+	if (value != 0 && value <= now) {
+		out->append(" (");
+		out->appendDuration(now - value);
+		out->append(" ago)");
+	}
+}
+
+/*
+ * Remote client info
+ * Some client data needs a server round trip: the connection info (ping, packet loss, bandwidth) requested with
+ * requestConnectionInfo and the client variables only sent after requestClientVariables (creation date, connection
+ * count, traffic). Both are answered asynchronously, so infoData renders with what is known and placeholders for the
+ * rest, and the event handlers ask the client for a single repaint once everything that was requested arrived.
+ */
+#define CONNECTIONINFO_REFRESH_MS 1000
+#define CLIENTVARIABLES_REFRESH_MS 60000
+#define REMOTE_PENDING_TIMEOUT_MS 2000  /* Stop waiting for the other answer before repainting */
+#define LOADING_PLACEHOLDER "loading..."
+
+/*
+ * Connection variables of a client, read in one pass when the connection info arrived so rendering does not go through
+ * the getters. Grouped values are indexed by kind: speech, keepalive, control and total, the order of the CONNECTION_*
+ * groups.
+ */
+#define CONNECTION_KINDS 4
+
+struct ConnectionStats {
+	double ping;
+	double pingDeviation;
+	uint64 connectedTime;  /* Milliseconds */
+	uint64 idleTime;
+	uint64 clientPort;
+	uint64 packetsSent[CONNECTION_KINDS];
+	uint64 bytesSent[CONNECTION_KINDS];
+	uint64 packetsReceived[CONNECTION_KINDS];
+	uint64 bytesReceived[CONNECTION_KINDS];
+	uint64 bandwidthSentSecond[CONNECTION_KINDS];      /* Bytes sent during the last second */
+	uint64 bandwidthSentMinute[CONNECTION_KINDS];      /* Bytes per second averaged over the last minute */
+	uint64 bandwidthReceivedSecond[CONNECTION_KINDS];
+	uint64 bandwidthReceivedMinute[CONNECTION_KINDS];
+	float packetLoss[CONNECTION_KINDS];                /* Probability of a lost packet, 0 to 1 */
+	float serverToClientLoss[CONNECTION_KINDS];
+	float clientToServerLoss[CONNECTION_KINDS];
+	char clientIP[64];                                 /* Empty if hidden by the server */
+};
+
+/* First flag of each group of CONNECTION_* counters and where they are kept */
+static const struct {
+	size_t flag;
+	uint64 (ConnectionStats::*values)[CONNECTION_KINDS];
+} connectionCounters[] = {
+	{ CONNECTION_PACKETS_SENT_SPEECH, &ConnectionStats::packetsSent },
+	{ CONNECTION_BYTES_SENT_SPEECH, &ConnectionStats::bytesSent },
+	{ CONNECTION_PACKETS_RECEIVED_SPEECH, &ConnectionStats::packetsReceived },
+	{ CONNECTION_BYTES_RECEIVED_SPEECH, &ConnectionStats::bytesReceived },
+	{ CONNECTION_BANDWIDTH_SENT_LAST_SECOND_SPEECH, &ConnectionStats::bandwidthSentSecond },
+	{ CONNECTION_BANDWIDTH_SENT_LAST_MINUTE_SPEECH, &ConnectionStats::bandwidthSentMinute },
+	{ CONNECTION_BANDWIDTH_RECEIVED_LAST_SECOND_SPEECH, &ConnectionStats::bandwidthReceivedSecond },
+	{ CONNECTION_BANDWIDTH_RECEIVED_LAST_MINUTE_SPEECH, &ConnectionStats::bandwidthReceivedMinute },
+};
+
+static const struct {
+	size_t flag;
+	float (ConnectionStats::*values)[CONNECTION_KINDS];
+} connectionLosses[] = {
+	{ CONNECTION_PACKETLOSS_SPEECH, &ConnectionStats::packetLoss },
+	{ CONNECTION_SERVER2CLIENT_PACKETLOSS_SPEECH, &ConnectionStats::serverToClientLoss },
+	{ CONNECTION_CLIENT2SERVER_PACKETLOSS_SPEECH, &ConnectionStats::clientToServerLoss },
+};
+
+/* Read all connection variables of a client, returns false if the client library has none */
+static bool readConnectionStats(uint64 serverConnectionHandlerID, anyID clientID, struct ConnectionStats* stats) {
+	*stats = ConnectionStats();
+	if (ts3Functions.getConnectionVariableAsDouble(serverConnectionHandlerID, clientID, CONNECTION_PING, &stats->ping) != ERROR_ok) {
+		return false;
+	}
+	/* Values the server does not share with us stay 0 */
+	ts3Functions.getConnectionVariableAsDouble(serverConnectionHandlerID, clientID, CONNECTION_PING_DEVIATION, &stats->pingDeviation);
+	ts3Functions.getConnectionVariableAsUInt64(serverConnectionHandlerID, clientID, CONNECTION_CONNECTED_TIME, &stats->connectedTime);
+	ts3Functions.getConnectionVariableAsUInt64(serverConnectionHandlerID, clientID, CONNECTION_IDLE_TIME, &stats->idleTime);
+	ts3Functions.getConnectionVariableAsUInt64(serverConnectionHandlerID, clientID, CONNECTION_CLIENT_PORT, &stats->clientPort);
+	for (size_t group = 0; group < sizeof(connectionCounters) / sizeof(connectionCounters[0]); ++group) {
+		uint64* values = stats->*connectionCounters[group].values;
+		for (size_t kind = 0; kind < CONNECTION_KINDS; ++kind) {
+			ts3Functions.getConnectionVariableAsUInt64(serverConnectionHandlerID, clientID, connectionCounters[group].flag + kind, &values[kind]);
+		}
+	}
+	for (size_t group = 0; group < sizeof(connectionLosses) / sizeof(connectionLosses[0]); ++group) {
+		float* values = stats->*connectionLosses[group].values;
+		for (size_t kind = 0; kind < CONNECTION_KINDS; ++kind) {
+			double loss = 0;
+			ts3Functions.getConnectionVariableAsDouble(serverConnectionHandlerID, clientID, connectionLosses[group].flag + kind, &loss);
+			values[kind] = (float)loss;
+		}
+	}
+	LibraryString clientIP;
+	if (ts3Functions.getConnectionVariableAsString(serverConnectionHandlerID, clientID, CONNECTION_CLIENT_IP, clientIP.out()) == ERROR_ok && clientIP.get()) {
+		_strcpy(stats->clientIP, sizeof(stats->clientIP), clientIP.get());  /* Addresses take at most 45 characters */
+	}
+	return true;
+}
+
+struct RemoteClientInfo {
+	struct ConnectionStats connection;
+	bool connectionValid;         /* connection holds values received from the server */
+	bool connectionPending;       /* Requested, not answered yet */
+	std::chrono::steady_clock::time_point connectionRequested;
+	bool variablesReady;    /* The client library holds the remote client variables */
+	bool variablesPending;
+	std::chrono::steady_clock::time_point variablesRequested;
+	bool repaint;           /* Data arrived for a render, repaint once nothing is pending anymore */
+};
+
+/*
+ * Property cache
+ * Server, channel and client variables rarely change between two renders of the info frame, so they are cached per
+ * (item, property) and dropped as soon as the client library announces an update of the item.
+ */
+struct InfoItem {
+	enum PluginItemType type;
+	uint64 id;
+
+	bool operator==(const InfoItem& other) const {
+		return type == other.type && id == other.id;
+	}
+};
+
+struct InfoItemHash {
+	size_t operator()(const InfoItem& item) const {
+		return std::hash<uint64>()(((uint64)item.type << 56) ^ item.id);
+	}
+};
+
+/* UIDs and group names, which repeat and never change, shared by all connections. The pool never frees a string. */
+static StringPool strings;
+
+struct PropertyValue {
+	int asInt;
+	uint64 asUInt64;
+	unsigned int asIdentifier;  /* Handle of a UID in strings, STRING_POOL_NONE for the other strings */
+	std::string asString;       /* Nicknames, messages, descriptions: freed with the cached variables of the shard */
+};
+
+/* Properties of one item, keyed by flag and value type since a flag might be queried through different getters */
+typedef std::unordered_map<size_t, struct PropertyValue> PropertyMap;
+
+template <typename T> struct PropertyType;
+template <> struct PropertyType<int> {
+	enum { index = 0 };
+	static void load(const struct PropertyValue& value, int* result) { *result = value.asInt; }
+	static void store(struct PropertyValue* value, const int& result, bool identifier) { value->asInt = result; }
+};
+template <> struct PropertyType<uint64> {
+	enum { index = 1 };
+	static void load(const struct PropertyValue& value, uint64* result) { *result = value.asUInt64; }
+	static void store(struct PropertyValue* value, const uint64& result, bool identifier) { value->asUInt64 = result; }
+};
+template <> struct PropertyType<std::string> {
+	enum { index = 2 };
+	static void load(const struct PropertyValue& value, std::string* result) {
+		if (value.asIdentifier != STRING_POOL_NONE) {
+			result->assign(strings.text(value.asIdentifier), strings.length(value.asIdentifier));
+		}
+		else {
+			*result = value.asString;
+		}
+	}
+	static void store(struct PropertyValue* value, const std::string& result, bool identifier) {
+		value->asIdentifier = identifier ? strings.intern(result.data(), result.length()) : STRING_POOL_NONE;
+		if (!identifier) {
+			value->asString = result;
+		}
+	}
+};
+
+/*
+ * Rendered info cache
+ * The client asks for the info text on every selection, hover refresh and requestInfoUpdate. The finished text is kept
+ * per item together with the generation it was rendered at. Events concerning the item bump its generation, as long as
+ * it did not change the stored text is handed out again without rendering.
+ */
+struct RenderedInfo {
+	uint64 generation;          /* Bumped by every event concerning the item */
+	uint64 renderedGeneration;  /* Generation text was rendered at */
+	bool rendered;
+	uint64 expires;             /* Steady milliseconds the text shows time dependent values for, 0 if it does not */
+	std::string text;
+};
+
+/*
+ * Group directory
+ * Clients only carry the IDs of their server groups and channel group. The names are collected per server connection
+ * from the group lists, requested once when the connection is established, so rendering resolves them without asking
+ * the server. Group IDs showing up in later events that are not in the directory yet trigger a new list request.
+ */
+struct GroupDirectory {
+	std::unordered_map<uint64, unsigned int> serverGroups;  /* Group ID to the handle of its name in strings */
+	std::unordered_map<uint64, unsigned int> channelGroups;
+	bool serverGroupsPending;   /* Requested, list not finished yet */
+	bool channelGroupsPending;
+	bool serverGroupsReceived;  /* A complete list arrived at least once */
+	bool channelGroupsReceived;
+};
+
+/*
+ * Server connection shards
+ * Everything the plugin knows about a server connection lives in its shard: remote client infos, cached variables,
+ * rendered texts, groups and the world model, each behind its own mutex. A shard is opened when the connection is
+ * established and closed on disconnect or server stop, which frees all of it at once. Callbacks look their shard up
+ * once and keep it alive through the shared pointer, so tabs never wait for each other; the shard table itself is only
+ * locked exclusively when a connection comes or goes.
+ */
+/* For durations, unlike the system clock it does not jump */
+static uint64 steadyMilliseconds() {
+	return (uint64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Token bucket of every server connection, set by the ratelimit command */
+static std::atomic<double> requestRate(REQUEST_DEFAULT_RATE);
+static std::atomic<unsigned int> requestBurst(REQUEST_DEFAULT_BURST);
+
+struct ServerShard {
+	uint64 serverConnectionHandlerID;
+	std::atomic<unsigned long long> droppedEvents;  /* Lost to a full event queue since the worker last resynced */
+
+	std::mutex requestMutex;
+	RequestScheduler requests;
+
+	std::mutex remoteInfoMutex;
+	std::unordered_map<anyID, struct RemoteClientInfo> remoteInfo;
+
+	std::mutex propertyMutex;
+	std::unordered_map<struct InfoItem, PropertyMap, struct InfoItemHash> properties;
+	uint64 propertyEpoch;  /* Bumped on every invalidation, values fetched before must not be stored anymore */
+
+	std::mutex renderedMutex;
+	std::unordered_map<struct InfoItem, struct RenderedInfo, struct InfoItemHash> rendered;
+
+	std::mutex groupMutex;
+	struct GroupDirectory groups;
+
+	std::mutex worldMutex;
+	World world;
+	bool worldSeeded;  /* Filled from the lists by the worker, events are applied from now on */
+	bool worldAwaited;        /* awaitedItem was rendered before, repaint it once seeded */
+	struct InfoItem awaitedItem;
+
+	std::mutex talkMutex;
+	TalkTime talkTime;
+
+	NameCache* names;  /* nameCacheMutex, NULL until the cache of the server is open */
+
+	explicit ServerShard(uint64 id) : serverConnectionHandlerID(id), droppedEvents(0), propertyEpoch(0), groups(), worldSeeded(false), worldAwaited(false), names(NULL) {
+		talkTime.start(steadyMilliseconds());
+		requests.configure(requestRate, requestBurst);
+	}
+};
+
+typedef std::shared_ptr<struct ServerShard> ShardPointer;
+
+static std::shared_mutex shardMutex;
+static std::unordered_map<uint64, ShardPointer> shards;
+
+/* Shard of a server connection, NULL if it is not established */
+static ShardPointer findShard(uint64 serverConnectionHandlerID) {
+	std::shared_lock<std::shared_mutex> lock(shardMutex);
+	std::unordered_map<uint64, ShardPointer>::const_iterator it = shards.find(serverConnectionHandlerID);
+	return it != shards.end() ? it->second : ShardPointer();
+}
+
+static ShardPointer openShard(uint64 serverConnectionHandlerID) {
+	std::lock_guard<std::shared_mutex> lock(shardMutex);
+	ShardPointer& shard = shards[serverConnectionHandlerID];
+	if (!shard) {
+		shard = std::make_shared<struct ServerShard>(serverConnectionHandlerID);
+	}
+	return shard;
+}
+
+/* Drop the shard of a connection, callbacks still using it release it when they return */
+static void closeShard(uint64 serverConnectionHandlerID) {
+	ShardPointer shard;
+	{
+		std::lock_guard<std::shared_mutex> lock(shardMutex);
+		std::unordered_map<uint64, ShardPointer>::iterator it = shards.find(serverConnectionHandlerID);
+		if (it == shards.end()) {
+			return;
+		}
+		shard.swap(it->second);
+		shards.erase(it);
+	}
+}
+
+static void closeAllShards() {
+	std::unordered_map<uint64, ShardPointer> closed;
+	{
+		std::lock_guard<std::shared_mutex> lock(shardMutex);
+		closed.swap(shards);
+	}
+}
+
+/* Open shards for the connections established before the plugin was loaded, the worker sets them up like new ones */
+static void openEstablishedShards() {
+	LibraryBuffer<uint64> connections;
+	if (ts3Functions.getServerConnectionHandlerList(connections.out()) != ERROR_ok) {
+		printf("Error getting server connection list\n");
+		return;
+	}
+	for (const uint64* connection = connections.get(); *connection; ++connection) {
+		int status;
+		if (ts3Functions.getConnectionStatus(*connection, &status) == ERROR_ok && status == STATUS_CONNECTION_ESTABLISHED) {
+			openShard(*connection);
+			postConnected(*connection);
+		}
+	}
+}
+
+/*
+ * Name caches
+ * UID, database ID and nickname of the clients of a server, taken from the answers to name lookups of the client and
+ * its plugins. Every server has a NameCache file in the config path, named after the server UID and mapped when the
+ * connection is established, so lookups are answered without asking the server, also in later sessions. Connections
+ * to the same server share the cache, caches stay open until shutdown. The answers come through the event queue, only
+ * the worker writes the caches.
+ */
+#define NAMECACHE_FILENAME_PREFIX "Informations."
+#define NAMECACHE_FILENAME_SUFFIX ".names"
+#define WHOIS_BUFSIZE 512
+
+static std::mutex nameCacheMutex;
+static std::string nameCacheDirectory;  /* Empty while the plugin is not initialized */
+static std::unordered_map<std::string, std::unique_ptr<NameCache> > nameCaches;  /* By server UID */
+static std::string whoisUID;            /* Lookup of the whois command waiting for the server */
+static uint64 whoisDatabaseID = 0;
+
+/*
+ * Request ID of a name lookup by UID: FNV-1a of the UID in the 56 bits the scheduler leaves for IDs, never 0. Typed
+ * UIDs stay out of the StringPool, which never frees, the text of the lookup is kept in whoisUID.
+ */
+static uint64 uidRequestID(const char* uid) {
+	uint64 hash = 14695981039346656037ULL;
+	for (; *uid; ++uid) {
+		hash = (hash ^ (unsigned char)*uid) * 1099511628211ULL;
+	}
+	hash &= (1ULL << 56) - 1;
+	return hash ? hash : 1;
+}
+
+/* UIDs are base64, keep the file name free of path separators */
+static std::string nameCacheFileName(const char* serverUID) {
+	std::string name = NAMECACHE_FILENAME_PREFIX;
+	for (const char* c = serverUID; *c; ++c) {
+		const bool plain = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '=';
+		name += plain ? *c : (*c == '/' ? '-' : '_');
+	}
+	return name + NAMECACHE_FILENAME_SUFFIX;
+}
+
+/* Map the cache of the server of a connection, done once its UID is known */
+static void openNameCache(struct ServerShard* shard) {
+	LibraryString serverUID;
+	if (ts3Functions.getServerVariableAsString(shard->serverConnectionHandlerID, VIRTUALSERVER_UNIQUE_IDENTIFIER, serverUID.out()) != ERROR_ok ||
+	    serverUID.get()[0] == '\0') {
+		printf("Error getting server UID\n");
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(nameCacheMutex);
+	if (nameCacheDirectory.empty()) {
+		return;
+	}
+	std::unique_ptr<NameCache>& cache = nameCaches[serverUID.get()];
+	if (!cache) {
+		cache.reset(new NameCache());
+		const std::string path = nameCacheDirectory + nameCacheFileName(serverUID.get());
+		if (!cache->open(path.c_str())) {
+			printf("Error opening %s\n", path.c_str());
+		}
+	}
+	shard->names = cache->isOpen() ? cache.get() : NULL;
+}
+
+/* Caches are opened by the worker when a connection is established, also for those established before loading */
+static void openNameCaches(const char* configPath) {
+	std::lock_guard<std::mutex> lock(nameCacheMutex);
+	nameCacheDirectory = configPath;
+}
+
+static void closeNameCaches() {
+	std::lock_guard<std::mutex> lock(nameCacheMutex);
+	nameCaches.clear();
+	nameCacheDirectory.clear();
+	whoisUID.clear();
+	whoisDatabaseID = 0;
+}
+
+static void printWhois(const struct NameRecord& record) {
+	char buffer[WHOIS_BUFSIZE];
+	TextWriter out(buffer, sizeof(buffer) - 1);
+	out.append(record.nickname[0] ? record.nickname : "(unknown nickname)");
+	out.append(" (database ID ");
+	out.appendNumber(record.databaseID);
+	out.append(", UID ");
+	out.append(record.uid);
+	out.append("), last seen ");
+	out.appendDate(record.lastSeen);
+	buffer[out.length()] = '\0';
+	ts3Functions.printMessageToCurrentTab(buffer);
+}
+
+/* Answer from the cache, or ask the server and answer when the name arrives */
+static void whois(uint64 serverConnectionHandlerID, const char* key) {
+	const ShardPointer shard = findShard(serverConnectionHandlerID);
+	if (!shard) {
+		ts3Functions.printMessageToCurrentTab("Not connected");
+		return;
+	}
+	char* end;
+	const uint64 databaseID = strtoull(key, &end, 10);
+	const bool byDatabaseID = end != key && *end == '\0';  /* UIDs end with '=' */
+
+	struct NameRecord record;
+	bool cached;
+	{
+		std::lock_guard<std::mutex> lock(nameCacheMutex);
+		cached = shard->names && (byDatabaseID ? shard->names->findByDatabaseID(databaseID, &record) : shard->names->findByUID(key, &record));
+		if (!cached) {
+			whoisUID = byDatabaseID ? "" : key;
+			whoisDatabaseID = byDatabaseID ? databaseID : 0;
+		}
+	}
+	if (cached) {
+		printWhois(record);
+		return;
+	}
+
+	if (byDatabaseID) {
+		scheduleRequest(shard.get(), REQUEST_NAME_FROM_DBID, databaseID, true);
+	}
+	else {
+		scheduleRequest(shard.get(), REQUEST_NAME_FROM_UID, uidRequestID(key), true);
+	}
+}
+
+/* Store an answer to a name lookup, databaseID 0 and nickname empty if the answer does not tell. Called by the worker. */
+static void rememberName(struct ServerShard* shard, const char* uid, uint64 databaseID, const char* nickname, uint64 now) {
+	{
+		std::lock_guard<std::mutex> lock(shard->requestMutex);
+		shard->requests.completed(REQUEST_NAME_FROM_UID, uidRequestID(uid), now);
+		if (databaseID) {
+			shard->requests.completed(REQUEST_NAME_FROM_DBID, databaseID, now);
+		}
+	}
+
+	struct NameRecord record;
+	bool answered = false;
+	{
+		std::lock_guard<std::mutex> lock(nameCacheMutex);
+		if (!shard->names) {
+			return;
+		}
+		shard->names->update(uid, databaseID, nickname, (uint64)time(NULL));
+		if ((!whoisUID.empty() && whoisUID == uid) || (whoisDatabaseID && whoisDatabaseID == databaseID)) {
+			answered = shard->names->findByUID(uid, &record);
+			whoisUID.clear();
+			whoisDatabaseID = 0;
+		}
+	}
+	if (answered) {
+		printWhois(record);
+	}
+}
+
+/*
+ * Server requests
+ * Every request to the server goes through the RequestScheduler of its shard, see requests.h. Callers mark what they
+ * asked for as pending before scheduling, so a queued request looks the same to them as one waiting for its answer.
+ * Queued requests are sent by the event worker, which wakes up at least every EVENT_WORKER_IDLE_MS.
+ * Once the client registered the plugin ID, requests carry a return code. The server answers it with
+ * ts3plugin_onServerErrorEvent after the answering events, error ERROR_ok on success, so the scheduler gets the round
+ * trip time of every command and learns about refused requests instead of waiting for their timeout.
+ */
+#define REQUEST_COUNTERS_BUFSIZE 256
+#define REQUEST_LATENCY_BUFSIZE 512
+
+static const char* const requestNames[REQUEST_COMMANDS] = {
+	"connection info", "client variables", "server group list", "channel group list", "name from UID", "name from database ID",
+};
+
+/* The events answering a request arrived at now, also when the client or another plugin asked for them */
+static void requestCompleted(struct ServerShard* shard, enum RequestCommand command, uint64 id, uint64 now) {
+	std::lock_guard<std::mutex> lock(shard->requestMutex);
+	shard->requests.completed(command, id, now);
+}
+
+/* The scheduler gave up a request: clear the pending flag of its caller, so it is requested again */
+static void requestFailed(struct ServerShard* shard, const struct Request& request) {
+	switch (request.command) {
+	case REQUEST_CONNECTION_INFO:
+	case REQUEST_CLIENT_VARIABLES: {
+		std::lock_guard<std::mutex> lock(shard->remoteInfoMutex);
+		std::unordered_map<anyID, struct RemoteClientInfo>::iterator it = shard->remoteInfo.find((anyID)request.id);
+		if (it != shard->remoteInfo.end()) {
+			(request.command == REQUEST_CONNECTION_INFO ? it->second.connectionPending : it->second.variablesPending) = false;
+		}
+		break;
+	}
+	case REQUEST_SERVER_GROUP_LIST:
+	case REQUEST_CHANNEL_GROUP_LIST: {
+		std::lock_guard<std::mutex> lock(shard->groupMutex);
+		(request.command == REQUEST_SERVER_GROUP_LIST ? shard->groups.serverGroupsPending : shard->groups.channelGroupsPending) = false;
+		break;
+	}
+	case REQUEST_NAME_FROM_UID:
+	case REQUEST_NAME_FROM_DBID: {
+		std::lock_guard<std::mutex> lock(nameCacheMutex);
+		if (request.command == REQUEST_NAME_FROM_UID ? !whoisUID.empty() && uidRequestID(whoisUID.c_str()) == request.id : whoisDatabaseID == request.id) {
+			whoisUID.clear();
+			whoisDatabaseID = 0;
+		}
+		break;
+	}
+	case REQUEST_COMMANDS:
+		break;
+	}
+}
+
+static void issueRequest(struct ServerShard* shard, const struct Request& request) {
+	const uint64 serverConnectionHandlerID = shard->serverConnectionHandlerID;
+	std::string uid;
+	if (request.command == REQUEST_NAME_FROM_UID) {
+		{
+			std::lock_guard<std::mutex> lock(nameCacheMutex);
+			if (!whoisUID.empty() && uidRequestID(whoisUID.c_str()) == request.id) {
+				uid = whoisUID;
+			}
+		}
+		if (uid.empty()) {  /* A later whois replaced the lookup, nobody waits for the answer */
+			std::lock_guard<std::mutex> lock(shard->requestMutex);
+			shard->requests.failed(request.command, request.id);
+			return;
+		}
+	}
+	char buffer[RETURNCODE_BUFSIZE];
+	const char* returnCode = NULL;
+	if (returnCodesEnabled) {
+		ts3Functions.createReturnCode(pluginID, buffer, sizeof(buffer));
+		returnCode = buffer;
+		std::lock_guard<std::mutex> lock(shard->requestMutex);
+		shard->requests.tag(request.command, request.id, returnCode);
+	}
+
+	unsigned int error = ERROR_ok;
+	switch (request.command) {
+	case REQUEST_CONNECTION_INFO:
+		error = ts3Functions.requestConnectionInfo(serverConnectionHandlerID, (anyID)request.id, returnCode);
+		break;
+	case REQUEST_CLIENT_VARIABLES:
+		error = ts3Functions.requestClientVariables(serverConnectionHandlerID, (anyID)request.id, returnCode);
+		break;
+	case REQUEST_SERVER_GROUP_LIST:
+		error = ts3Functions.requestServerGroupList(serverConnectionHandlerID, returnCode);
+		break;
+	case REQUEST_CHANNEL_GROUP_LIST:
+		error = ts3Functions.requestChannelGroupList(serverConnectionHandlerID, returnCode);
+		break;
+	case REQUEST_NAME_FROM_UID:
+		error = ts3Functions.requestClientNamefromUID(serverConnectionHandlerID, uid.c_str(), returnCode);
+		break;
+	case REQUEST_NAME_FROM_DBID:
+		error = ts3Functions.requestClientNamefromDBID(serverConnectionHandlerID, request.id, returnCode);
+		break;
+	case REQUEST_COMMANDS:
+		break;
+	}
+	if (error != ERROR_ok) {
+		printf("Error requesting %s\n", requestNames[request.command]);
+		{
+			std::lock_guard<std::mutex> lock(shard->requestMutex);
+			shard->requests.failed(request.command, request.id);
+		}
+		requestFailed(shard, request);
+	}
+}
+
+/* Answer of the server to a return code, returns false if the return code is not one of a request of the plugin */
+static bool requestAnswered(uint64 serverConnectionHandlerID, const char* returnCode, unsigned int error, const char* errorMessage) {
+	const ShardPointer shard = findShard(serverConnectionHandlerID);
+	if (!shard || !returnCode || returnCode[0] == '\0') {
+		return false;
+	}
+	struct Request request;
+	enum RequestAnswer answer;
+	{
+		std::lock_guard<std::mutex> lock(shard->requestMutex);
+		answer = shard->requests.answered(returnCode, error == ERROR_ok, steadyMilliseconds(), &request);
+	}
+	if (answer == REQUEST_ANSWER_FAILED) {
+		printf("Error requesting %s: %s (%u)\n", requestNames[request.command], errorMessage ? errorMessage : "", error);
+		requestFailed(shard.get(), request);
+	}
+	return answer != REQUEST_ANSWER_UNKNOWN;
+}
+
+/* Send a request now if a token is left, else the event worker sends it later */
+static void scheduleRequest(struct ServerShard* shard, enum RequestCommand command, uint64 id, bool urgent) {
+	enum RequestDecision decision;
+	{
+		std::lock_guard<std::mutex> lock(shard->requestMutex);
+		decision = shard->requests.submit(command, id, urgent, steadyMilliseconds());
+	}
+	if (decision == REQUEST_ISSUE) {
+		const struct Request request = { command, id };
+		issueRequest(shard, request);
+	}
+}
+
+/* Send the queued requests that got a token and give up the ones waiting too long, on the event worker */
+static void sendQueuedRequests() {
+	std::shared_lock<std::shared_mutex> shardLock(shardMutex);
+	for (std::unordered_map<uint64, ShardPointer>::const_iterator it = shards.begin(); it != shards.end(); ++it) {
+		struct ServerShard* shard = it->second.get();
+		for (;;) {
+			struct Request request;
+			enum RequestDecision decision;
+			{
+				std::lock_guard<std::mutex> lock(shard->requestMutex);
+				decision = shard->requests.next(steadyMilliseconds(), &request);
+			}
+			if (decision == REQUEST_ISSUE) {
+				issueRequest(shard, request);
+			}
+			else if (decision == REQUEST_EXPIRED) {
+				requestFailed(shard, request);
+			}
+			else {
+				break;
+			}
+		}
+	}
+}
+
+static void writeRequestLimit(TextWriter* out) {
+	out->append("limit ");
+	out->appendFixed((uint64)(requestRate * 10 + 0.5), 1);
+	out->append(" per second, burst ");
+	out->appendNumber(requestBurst.load());
+}
+
+/* Round trips of a command as "name: n answered, average n ms, slowest n ms; <25ms: n, 25-50ms: n, ..., >1600ms: n" */
+static void printRequestLatency(const char* name, const struct RequestLatency& latency) {
+	char buffer[REQUEST_LATENCY_BUFSIZE];
+	TextWriter out(buffer, sizeof(buffer) - 1);
+	out.append(name);
+	out.append(": ");
+	out.appendNumber(latency.answers);
+	out.append(" answered, average ");
+	out.appendNumber(latency.total / latency.answers);
+	out.append(" ms, slowest ");
+	out.appendNumber(latency.slowest);
+	out.append(" ms");
+	const char* separator = "; ";
+	for (unsigned int i = 0; i < REQUEST_LATENCY_BUCKETS; ++i) {
+		if (latency.histogram[i] == 0) {
+			continue;
+		}
+		out.append(separator);
+		separator = ", ";
+		if (i == 0) {
+			out.append('<');
+			out.appendNumber(RequestScheduler::bucketStart(1));
+		}
+		else if (i == REQUEST_LATENCY_BUCKETS - 1) {
+			out.append('>');
+			out.appendNumber(RequestScheduler::bucketStart(i));
+		}
+		else {
+			out.appendNumber(RequestScheduler::bucketStart(i));
+			out.append('-');
+			out.appendNumber(RequestScheduler::bucketStart(i + 1));
+		}
+		out.append("ms: ");
+		out.appendNumber(latency.histogram[i]);
+	}
+	buffer[out.length()] = '\0';
+	ts3Functions.printMessageToCurrentTab(buffer);
+}
+
+static void printRequestCounters(uint64 serverConnectionHandlerID) {
+	const ShardPointer shard = findShard(serverConnectionHandlerID);
+	if (!shard) {
+		ts3Functions.printMessageToCurrentTab("Not connected");
+		return;
+	}
+	struct RequestCounters counters;
+	struct RequestLatency latencies[REQUEST_COMMANDS];
+	size_t queued;
+	size_t pending;
+	{
+		std::lock_guard<std::mutex> lock(shard->requestMutex);
+		counters = shard->requests.counters();
+		for (int command = 0; command < REQUEST_COMMANDS; ++command) {
+			latencies[command] = shard->requests.latency((enum RequestCommand)command);
+		}
+		queued = shard->requests.queued();
+		pending = shard->requests.pending();
+	}
+
+	char buffer[REQUEST_COUNTERS_BUFSIZE];
+	TextWriter out(buffer, sizeof(buffer) - 1);
+	out.append("Requests: ");
+	out.appendNumber(counters.issued);
+	out.append(" issued, ");
+	out.appendNumber(counters.coalesced);
+	out.append(" coalesced, ");
+	out.appendNumber(counters.throttled);
+	out.append(" throttled, ");
+	out.appendNumber(counters.expired);
+	out.append(" expired, ");
+	out.appendNumber(counters.failed);
+	out.append(" failed, ");
+	out.appendNumber(counters.timedOut);
+	out.append(" timed out, ");
+	out.appendNumber(counters.retried);
+	out.append(" retried, ");
+	out.appendNumber(queued);
+	out.append(" queued, ");
+	out.appendNumber(pending);
+	out.append(" waiting for an answer; ");
+	writeRequestLimit(&out);
+	buffer[out.length()] = '\0';
+	ts3Functions.printMessageToCurrentTab(buffer);
+
+	for (int command = 0; command < REQUEST_COMMANDS; ++command) {
+		const struct RequestLatency& latency = latencies[command];
+		if (latency.answers > 0) {
+			printRequestLatency(requestNames[command], latency);
+		}
+	}
+}
+
+/* Change the token bucket of every server connection, queued requests are kept */
+static void limitRequests(double rate, unsigned int burst) {
+	if (!(rate > 0) || burst < 1) {
+		ts3Functions.printMessageToCurrentTab("The rate must be positive and the burst at least 1");
+		return;
+	}
+	requestRate = rate;
+	requestBurst = burst;
+	{
+		std::shared_lock<std::shared_mutex> shardLock(shardMutex);
+		for (std::unordered_map<uint64, ShardPointer>::const_iterator it = shards.begin(); it != shards.end(); ++it) {
+			std::lock_guard<std::mutex> lock(it->second->requestMutex);
+			it->second->requests.configure(rate, burst);
+		}
+	}
+
+	char buffer[REQUEST_COUNTERS_BUFSIZE];
+	TextWriter out(buffer, sizeof(buffer) - 1);
+	out.append("Requests: ");
+	writeRequestLimit(&out);
+	buffer[out.length()] = '\0';
+	ts3Functions.printMessageToCurrentTab(buffer);
+}
+
+/* Remote client infos */
+static bool stillPending(bool pending, std::chrono::steady_clock::time_point requested, std::chrono::steady_clock::time_point now) {
+	return pending && now - requested < std::chrono::milliseconds(REMOTE_PENDING_TIMEOUT_MS);
+}
+
+/*
+ * Copy what is known about a client into result and request outdated data in the background.
+ * wantConnection and wantVariables tell which data the shown fields need.
+ */
+static void getRemoteInfo(struct ServerShard* shard, anyID clientID, bool wantConnection, bool wantVariables, struct RemoteClientInfo* result) {
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	bool requestConnection = false;
+	bool requestVariables = false;
+	{
+		std::lock_guard<std::mutex> lock(shard->remoteInfoMutex);
+		std::unordered_map<anyID, struct RemoteClientInfo>::iterator it = shard->remoteInfo.find(clientID);
+		if (it == shard->remoteInfo.end()) {
+			struct RemoteClientInfo info = { ConnectionStats(), false, false, now, false, false, now, false };
+			it = shard->remoteInfo.insert(std::make_pair(clientID, info)).first;
+			requestConnection = wantConnection;
+			requestVariables = wantVariables;
+		}
+		else {
+			requestConnection = wantConnection && (!it->second.connectionPending || !it->second.connectionValid) &&
+				now - it->second.connectionRequested >= std::chrono::milliseconds(CONNECTIONINFO_REFRESH_MS);
+			requestVariables = wantVariables && !stillPending(it->second.variablesPending, it->second.variablesRequested, now) &&
+				(!it->second.variablesReady || now - it->second.variablesRequested >= std::chrono::milliseconds(CLIENTVARIABLES_REFRESH_MS));
+		}
+		if (requestConnection) {
+			it->second.connectionPending = true;
+			it->second.connectionRequested = now;
+		}
+		if (requestVariables) {
+			it->second.variablesPending = true;
+			it->second.variablesRequested = now;
+		}
+		*result = it->second;
+	}
+
+	if (requestConnection) {
+		scheduleRequest(shard, REQUEST_CONNECTION_INFO, clientID, false);
+	}
+	if (requestVariables) {
+		scheduleRequest(shard, REQUEST_CLIENT_VARIABLES, clientID, false);
+	}
+}
+
+/*
+ * Answer to requestConnectionInfo or requestClientVariables arrived, returns true if the info frame should be repainted now.
+ * changed tells whether the shown data differs from the last render.
+ */
+static bool remoteInfoArrived(struct RemoteClientInfo* info, bool changed) {
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (changed) {
+		info->repaint = true;
+	}
+	if (!info->repaint || stillPending(info->connectionPending, info->connectionRequested, now) || stillPending(info->variablesPending, info->variablesRequested, now)) {
+		return false;
+	}
+	info->repaint = false;
+	return true;
+}
+
+/* Forget what is known about a client that left */
+static void forgetRemoteInfo(struct ServerShard* shard, anyID clientID) {
+	std::lock_guard<std::mutex> lock(shard->remoteInfoMutex);
+	shard->remoteInfo.erase(clientID);
+}
+
+/* Cached variables */
+
+/* Query a variable from the client library, bypassing the cache */
+static unsigned int fetchVariable(uint64 serverConnectionHandlerID, enum PluginItemType type, uint64 id, size_t flag, int* result) {
+	switch (type) {
+	case PLUGIN_SERVER:
+		return ts3Functions.getServerVariableAsInt(serverConnectionHandlerID, flag, result);
+	case PLUGIN_CHANNEL:
+		return ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, id, flag, result);
+	default:
+		return ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, (anyID)id, flag, result);
+	}
+}
+
+static unsigned int fetchVariable(uint64 serverConnectionHandlerID, enum PluginItemType type, uint64 id, size_t flag, uint64* result) {
+	switch (type) {
+	case PLUGIN_SERVER:
+		return ts3Functions.getServerVariableAsUInt64(serverConnectionHandlerID, flag, result);
+	case PLUGIN_CHANNEL:
+		return ts3Functions.getChannelVariableAsUInt64(serverConnectionHandlerID, id, flag, result);
+	default:
+		return ts3Functions.getClientVariableAsUInt64(serverConnectionHandlerID, (anyID)id, flag, result);
+	}
+}
+
+static unsigned int fetchVariable(uint64 serverConnectionHandlerID, enum PluginItemType type, uint64 id, size_t flag, std::string* result) {
+	LibraryString value;
+	unsigned int error;
+	switch (type) {
+	case PLUGIN_SERVER:
+		error = ts3Functions.getServerVariableAsString(serverConnectionHandlerID, flag, value.out());
+		break;
+	case PLUGIN_CHANNEL:
+		error = ts3Functions.getChannelVariableAsString(serverConnectionHandlerID, id, flag, value.out());
+		break;
+	default:
+		error = ts3Functions.getClientVariableAsString(serverConnectionHandlerID, (anyID)id, flag, value.out());
+		break;
+	}
+	if (error == ERROR_ok) {
+		*result = value.get();
+	}
+	return error;
+}
+
+/* Variables holding a UID, the only ones worth interning */
+static bool identifierVariable(enum PluginItemType type, size_t flag) {
+	return (type == PLUGIN_SERVER && flag == VIRTUALSERVER_UNIQUE_IDENTIFIER) || (type == PLUGIN_CLIENT && flag == CLIENT_UNIQUE_IDENTIFIER);
+}
+
+/* Get a server (id is ignored), channel or client variable, the getter is picked by the type of result */
+template <typename T>
+static unsigned int getVariable(struct ServerShard* shard, enum PluginItemType type, uint64 id, size_t flag, T* result) {
+	const struct InfoItem item = { type, type == PLUGIN_SERVER ? 0 : id };
+	const size_t key = (flag << 2) | PropertyType<T>::index;
+	uint64 epoch;
+	{
+		std::lock_guard<std::mutex> lock(shard->propertyMutex);
+		std::unordered_map<struct InfoItem, PropertyMap, struct InfoItemHash>::iterator it = shard->properties.find(item);
+		if (it != shard->properties.end()) {
+			PropertyMap::iterator value = it->second.find(key);
+			if (value != it->second.end()) {
+				PropertyType<T>::load(value->second, result);
+				return ERROR_ok;
+			}
+		}
+		epoch = shard->propertyEpoch;
+	}
+
+	const unsigned int error = fetchVariable(shard->serverConnectionHandlerID, type, id, flag, result);
+	if (error == ERROR_ok) {
+		std::lock_guard<std::mutex> lock(shard->propertyMutex);
+		if (epoch == shard->propertyEpoch) {
+			PropertyType<T>::store(&shard->properties[item][key], *result, identifierVariable(type, flag));
+		}
+	}
+	return error;
+}
+
+/* Drop the cached variables of a single server, channel or client */
+static void invalidateVariables(struct ServerShard* shard, enum PluginItemType type, uint64 id) {
+	const struct InfoItem item = { type, id };
+	std::lock_guard<std::mutex> lock(shard->propertyMutex);
+	shard->properties.erase(item);
+	++shard->propertyEpoch;
+}
+
+/* Rendered texts */
+
+/* Copy the rendered text of an item into a buffer for the client if it is still current, else return the generation to render at */
+static char* findRenderedInfo(struct ServerShard* shard, const struct InfoItem& item, uint64* generation) {
+	std::lock_guard<std::mutex> lock(shard->renderedMutex);
+	struct RenderedInfo& info = shard->rendered[item];
+	if (!info.rendered || info.renderedGeneration != info.generation || (info.expires && steadyMilliseconds() >= info.expires)) {
+		*generation = info.generation;
+		return NULL;
+	}
+	char* data = (char*)malloc((info.text.length() + 1) * sizeof(char));
+	if (data) {
+		memcpy(data, info.text.c_str(), info.text.length() + 1);
+	}
+	return data;
+}
+
+/* Remember the text rendered at generation for refresh milliseconds (0 for good), unless the item changed while rendering */
+static void storeRenderedInfo(struct ServerShard* shard, const struct InfoItem& item, uint64 generation, unsigned int refresh, const char* text) {
+	const uint64 expires = refresh ? steadyMilliseconds() + refresh : 0;
+	std::lock_guard<std::mutex> lock(shard->renderedMutex);
+	std::unordered_map<struct InfoItem, struct RenderedInfo, struct InfoItemHash>::iterator it = shard->rendered.find(item);
+	if (it != shard->rendered.end() && it->second.generation == generation) {
+		it->second.renderedGeneration = generation;
+		it->second.rendered = true;
+		it->second.expires = expires;
+		it->second.text = text;
+	}
+}
+
+/* Outdate the rendered text of an item, items that were never rendered are not tracked */
+static void bumpGeneration(struct ServerShard* shard, enum PluginItemType type, uint64 id) {
+	const struct InfoItem item = { type, id };
+	std::lock_guard<std::mutex> lock(shard->renderedMutex);
+	std::unordered_map<struct InfoItem, struct RenderedInfo, struct InfoItemHash>::iterator it = shard->rendered.find(item);
+	if (it != shard->rendered.end()) {
+		++it->second.generation;
+	}
+}
+
+/* Forget the rendered text of an item that is gone */
+static void forgetRenderedInfo(struct ServerShard* shard, enum PluginItemType type, uint64 id) {
+	const struct InfoItem item = { type, id };
+	std::lock_guard<std::mutex> lock(shard->renderedMutex);
+	shard->rendered.erase(item);
+}
+
+/* Forget all rendered texts of a server connection */
+static void clearRenderedInfo(struct ServerShard* shard) {
+	std::lock_guard<std::mutex> lock(shard->renderedMutex);
+	shard->rendered.clear();
+}
+
+/* Forget all rendered texts */
+static void clearRenderedInfo() {
+	std::shared_lock<std::shared_mutex> lock(shardMutex);
+	for (std::unordered_map<uint64, ShardPointer>::const_iterator it = shards.begin(); it != shards.end(); ++it) {
+		clearRenderedInfo(it->second.get());
+	}
+}
+
+/* A client left the server, its ID will be reused */
+static void clientLeft(struct ServerShard* shard, anyID clientID) {
+	invalidateVariables(shard, PLUGIN_CLIENT, clientID);
+	forgetRenderedInfo(shard, PLUGIN_CLIENT, clientID);
+	forgetRemoteInfo(shard, clientID);
+	/* Requests still queued for it are pointless */
+	std::lock_guard<std::mutex> lock(shard->requestMutex);
+	shard->requests.cancel(REQUEST_CONNECTION_INFO, clientID);
+	shard->requests.cancel(REQUEST_CLIENT_VARIABLES, clientID);
+}
+
+/* An item changed: drop its cached variables and outdate its rendered text */
+static void invalidateItem(struct ServerShard* shard, enum PluginItemType type, uint64 id) {
+	invalidateVariables(shard, type, id);
+	bumpGeneration(shard, type, id);
+}
+
+/* Groups */
+
+/* Request the server and/or channel group list unless a request is still outstanding */
+static void requestGroupLists(struct ServerShard* shard, bool serverGroups, bool channelGroups) {
+	struct GroupDirectory& directory = shard->groups;
+	{
+		std::lock_guard<std::mutex> lock(shard->groupMutex);
+		serverGroups = serverGroups && !directory.serverGroupsPending;
+		channelGroups = channelGroups && !directory.channelGroupsPending;
+		directory.serverGroupsPending |= serverGroups;
+		directory.channelGroupsPending |= channelGroups;
+	}
+
+	if (serverGroups) {
+		scheduleRequest(shard, REQUEST_SERVER_GROUP_LIST, 0, false);
+	}
+	if (channelGroups) {
+		scheduleRequest(shard, REQUEST_CHANNEL_GROUP_LIST, 0, false);
+	}
+}
+
+/* Returns true if the group is in the directory */
+static bool knownGroup(struct ServerShard* shard, bool serverGroup, uint64 groupID) {
+	std::lock_guard<std::mutex> lock(shard->groupMutex);
+	const std::unordered_map<uint64, unsigned int>& groups = serverGroup ? shard->groups.serverGroups : shard->groups.channelGroups;
+	return groups.find(groupID) != groups.end();
+}
+
+/*
+ * Write "name (id)", or just the ID while the name is unknown. Returns false if the name is unknown and no list was
+ * received yet, so the caller can request it.
+ */
+static bool writeGroup(struct ServerShard* shard, bool serverGroup, uint64 groupID, TextWriter* out) {
+	std::lock_guard<std::mutex> lock(shard->groupMutex);
+	const struct GroupDirectory& directory = shard->groups;
+	const std::unordered_map<uint64, unsigned int>& groups = serverGroup ? directory.serverGroups : directory.channelGroups;
+	std::unordered_map<uint64, unsigned int>::const_iterator group = groups.find(groupID);
+	if (group != groups.end()) {
+		out->append(strings.text(group->second), strings.length(group->second));
+		out->append(" (");
+		out->appendNumber(groupID);
+		out->append(')');
+		return true;
+	}
+	out->appendNumber(groupID);
+	return serverGroup ? directory.serverGroupsReceived : directory.channelGroupsReceived;
+}
+
+/*
+ * World model
+ * Mirror of the channel tree and client list of every server connection. It is filled from the channel and client
+ * lists once the connection is established, or on first use if the plugin was loaded while connected, and kept up to
+ * date by the channel and client events afterwards, so rendering never walks the lists of the client library.
+ */
+
+/* Read the sort order and WORLD_CHANNEL_* flags of a channel */
+static void readChannel(uint64 serverConnectionHandlerID, uint64 channelID, uint64* order, unsigned int* flags) {
+	static const struct {
+		size_t flag;
+		unsigned int worldFlag;
+	} channelFlags[] = {
+		{ CHANNEL_FLAG_PERMANENT, WORLD_CHANNEL_PERMANENT },
+		{ CHANNEL_FLAG_SEMI_PERMANENT, WORLD_CHANNEL_SEMI_PERMANENT },
+		{ CHANNEL_FLAG_DEFAULT, WORLD_CHANNEL_DEFAULT },
+		{ CHANNEL_FLAG_PASSWORD, WORLD_CHANNEL_PASSWORD },
+		{ CHANNEL_FLAG_ARE_SUBSCRIBED, WORLD_CHANNEL_SUBSCRIBED },
+	};
+	*order = 0;
+	*flags = 0;
+	ts3Functions.getChannelVariableAsUInt64(serverConnectionHandlerID, channelID, CHANNEL_ORDER, order);
+	for (size_t i = 0; i < sizeof(channelFlags) / sizeof(channelFlags[0]); ++i) {
+		int value = 0;
+		if (ts3Functions.getChannelVariableAsInt(serverConnectionHandlerID, channelID, channelFlags[i].flag, &value) == ERROR_ok && value) {
+			*flags |= channelFlags[i].worldFlag;
+		}
+	}
+}
+
+/* Add a channel to the world, with its parents if they are missing. Call with worldMutex held. */
+static void addChannel(uint64 serverConnectionHandlerID, World* world, uint64 channelID, uint64 parentID) {
+	if (parentID != 0 && !world->hasChannel(parentID)) {
+		uint64 grandparentID = 0;
+		if (ts3Functions.getParentChannelOfChannel(serverConnectionHandlerID, parentID, &grandparentID) != ERROR_ok) {
+			printf("Error getting parent of channel %llu\n", (unsigned long long)parentID);
+		}
+		addChannel(serverConnectionHandlerID, world, parentID, grandparentID);
+	}
+	uint64 order;
+	unsigned int flags;
+	readChannel(serverConnectionHandlerID, channelID, &order, &flags);
+	world->addChannel(channelID, parentID, order, flags);
+}
+
+/* Make a channel known to the world. Call with worldMutex held. */
+static void knowChannel(uint64 serverConnectionHandlerID, World* world, uint64 channelID) {
+	if (channelID == 0 || world->hasChannel(channelID)) {
+		return;
+	}
+	uint64 parentID = 0;
+	if (ts3Functions.getParentChannelOfChannel(serverConnectionHandlerID, channelID, &parentID) != ERROR_ok) {
+		printf("Error getting parent of channel %llu\n", (unsigned long long)channelID);
+	}
+	addChannel(serverConnectionHandlerID, world, channelID, parentID);
+}
+
+/* Read the muted and away flags of a client, talking and query are kept from flags */
+static unsigned int readClientFlags(uint64 serverConnectionHandlerID, anyID clientID, unsigned int flags) {
+	int inputMuted = 0;
+	int outputMuted = 0;
+	int away = 0;
+	ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, clientID, CLIENT_INPUT_MUTED, &inputMuted);
+	ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, clientID, CLIENT_OUTPUT_MUTED, &outputMuted);
+	ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, clientID, CLIENT_AWAY, &away);
+	flags &= ~(WORLD_CLIENT_MUTED | WORLD_CLIENT_AWAY);
+	flags |= (inputMuted || outputMuted ? WORLD_CLIENT_MUTED : 0) | (away ? WORLD_CLIENT_AWAY : 0);
+	return flags;
+}
+
+/* Put a client that is new to the world into channelID. Call with worldMutex held. */
+static void addClient(uint64 serverConnectionHandlerID, World* world, anyID clientID, uint64 channelID) {
+	int talking = 0;
+	int clientType = 0;
+	ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, clientID, CLIENT_FLAG_TALKING, &talking);
+	ts3Functions.getClientVariableAsInt(serverConnectionHandlerID, clientID, CLIENT_TYPE, &clientType);
+	unsigned int flags = (talking ? WORLD_CLIENT_TALKING : 0) | (clientType == 1 ? WORLD_CLIENT_QUERY : 0);
+	flags = readClientFlags(serverConnectionHandlerID, clientID, flags);
+
+	unsigned int uid = WORLD_NO_UID;
+	LibraryString uniqueIdentifier;
+	if (ts3Functions.getClientVariableAsString(serverConnectionHandlerID, clientID, CLIENT_UNIQUE_IDENTIFIER, uniqueIdentifier.out()) == ERROR_ok) {
+		uid = strings.intern(uniqueIdentifier.get());
+	}
+	knowChannel(serverConnectionHandlerID, world, channelID);
+	world->setClient(clientID, channelID, flags, uid);
+}
+
+/* Outdate the rendered text of the server dashboard, a channel and its parents */
+static void bumpChannelFamily(struct ServerShard* shard, uint64 channelID) {
+	bumpGeneration(shard, PLUGIN_SERVER, 0);
+	while (channelID != 0) {
+		bumpGeneration(shard, PLUGIN_CHANNEL, channelID);
+		channelID = shard->world.parentOf(channelID);
+	}
+}
+
+/* Fill the world of a server connection from the channel and client list, on the worker only */
+static void seedWorld(struct ServerShard* shard) {
+	const uint64 serverConnectionHandlerID = shard->serverConnectionHandlerID;
+	struct InfoItem awaited;
+	{
+		std::lock_guard<std::mutex> lock(shard->worldMutex);
+		LibraryBuffer<uint64> channels;
+		LibraryBuffer<anyID> clients;
+		if (ts3Functions.getChannelList(serverConnectionHandlerID, channels.out()) != ERROR_ok ||
+			ts3Functions.getClientList(serverConnectionHandlerID, clients.out()) != ERROR_ok) {
+			printf("Error getting channel and client list\n");
+			return;
+		}
+		shard->world.clear();
+		for (const uint64* channel = channels.get(); *channel; ++channel) {
+			knowChannel(serverConnectionHandlerID, &shard->world, *channel);
+		}
+		for (const anyID* client = clients.get(); *client; ++client) {
+			uint64 channelID;
+			if (ts3Functions.getChannelOfClient(serverConnectionHandlerID, *client, &channelID) == ERROR_ok) {
+				addClient(serverConnectionHandlerID, &shard->world, *client, channelID);
+			}
+		}
+		shard->worldSeeded = true;
+		if (!shard->worldAwaited) {
+			return;
+		}
+		shard->worldAwaited = false;
+		awaited = shard->awaitedItem;
+	}
+	/* Texts rendered meanwhile show the world as unavailable */
+	clearRenderedInfo(shard);
+	ts3Functions.requestInfoUpdate(serverConnectionHandlerID, awaited.type, awaited.id);
+}
+
+/* World for rendering an item, NULL until the worker seeded it, the item is then repainted. Call with worldMutex held. */
+static const World* renderedWorld(struct ServerShard* shard, enum PluginItemType type, uint64 id) {
+	if (!shard->worldSeeded) {
+		shard->worldAwaited = true;
+		shard->awaitedItem.type = type;
+		shard->awaitedItem.id = id;
+		return NULL;
+	}
+	return &shard->world;
+}
+
+/* World of a connection that is already seeded, NULL if events can be ignored. Call with worldMutex held. */
+static World* trackedWorld(struct ServerShard* shard) {
+	return shard->worldSeeded ? &shard->world : NULL;
+}
+
+/* A client entered, moved or left the server (newChannelID 0) */
+static void worldClientMoved(struct ServerShard* shard, anyID clientID, uint64 newChannelID) {
+	std::lock_guard<std::mutex> lock(shard->worldMutex);
+	World* world = trackedWorld(shard);
+	if (!world) {
+		return;
+	}
+
+	const struct WorldClient* client = world->findClient(clientID);
+	if (client) {
+		bumpChannelFamily(shard, client->channelID);
+		if (newChannelID == 0) {
+			world->removeClient(clientID);
+			return;
+		}
+		knowChannel(shard->serverConnectionHandlerID, world, newChannelID);
+		client = world->findClient(clientID);
+		world->setClient(clientID, newChannelID, client->flags, client->uid);
+	}
+	else if (newChannelID != 0) {
+		addClient(shard->serverConnectionHandlerID, world, clientID, newChannelID);
+	}
+	bumpChannelFamily(shard, newChannelID);
+}
+
+/* Talking, muted or away state of a client changed, talking is -1 if unchanged */
+static void worldClientChanged(struct ServerShard* shard, anyID clientID, int talking) {
+	std::lock_guard<std::mutex> lock(shard->worldMutex);
+	World* world = trackedWorld(shard);
+	const struct WorldClient* client = world ? world->findClient(clientID) : NULL;
+	if (!client) {
+		return;
+	}
+
+	unsigned int flags = client->flags;
+	if (talking >= 0) {
+		flags = talking ? flags | WORLD_CLIENT_TALKING : flags & ~WORLD_CLIENT_TALKING;
+	}
+	else {
+		flags = readClientFlags(shard->serverConnectionHandlerID, clientID, flags);
+	}
+	if (flags != client->flags) {
+		world->setClient(clientID, client->channelID, flags, client->uid);
+		bumpChannelFamily(shard, client->channelID);
+	}
+}
+
+/* A channel was created, or announced while connecting */
+static void worldChannelAdded(struct ServerShard* shard, uint64 channelID, uint64 parentID) {
+	std::lock_guard<std::mutex> lock(shard->worldMutex);
+	World* world = trackedWorld(shard);
+	if (world) {
+		addChannel(shard->serverConnectionHandlerID, world, channelID, parentID);
+	}
+}
+
+/* Sort order or flags of a channel may have changed */
+static void worldChannelUpdated(struct ServerShard* shard, uint64 channelID) {
+	std::lock_guard<std::mutex> lock(shard->worldMutex);
+	World* world = trackedWorld(shard);
+	if (world && world->hasChannel(channelID)) {
+		uint64 order;
+		unsigned int flags;
+		readChannel(shard->serverConnectionHandlerID, channelID, &order, &flags);
+		world->updateChannel(channelID, order, flags);
+	}
+}
+
+static void worldChannelMoved(struct ServerShard* shard, uint64 channelID, uint64 parentID) {
+	std::lock_guard<std::mutex> lock(shard->worldMutex);
+	World* world = trackedWorld(shard);
+	if (world && world->hasChannel(channelID)) {
+		bumpChannelFamily(shard, world->parentOf(channelID));
+		knowChannel(shard->serverConnectionHandlerID, world, parentID);
+		uint64 order = 0;
+		ts3Functions.getChannelVariableAsUInt64(shard->serverConnectionHandlerID, channelID, CHANNEL_ORDER, &order);
+		world->moveChannel(channelID, parentID, order);
+		bumpChannelFamily(shard, channelID);
+	}
+}
+
+static void worldChannelDeleted(struct ServerShard* shard, uint64 channelID) {
+	std::lock_guard<std::mutex> lock(shard->worldMutex);
+	World* world = trackedWorld(shard);
+	if (world) {
+		bumpChannelFamily(shard, world->parentOf(channelID));
+		world->removeChannel(channelID);
+	}
+}
+
+#define WORLD_PLACEHOLDER "unavailable"  /* Shown until the worker seeded the world */
+
+/* Write "clients (n talking, n muted, n away, n query)" for the whole server */
+static bool writeServerOccupancy(struct ServerShard* shard, TextWriter* out) {
+	struct ServerCounts totals;
+	{
+		std::lock_guard<std::mutex> lock(shard->worldMutex);
+		const World* world = renderedWorld(shard, PLUGIN_SERVER, 0);
+		if (!world) {
+			out->append(WORLD_PLACEHOLDER);
+			return true;
+		}
+		totals = world->totals();
+	}
+
+	out->appendNumber(totals.clients);
+	out->append(" (");
+	out->appendNumber(totals.talking);
+	out->append(" talking, ");
+	out->appendNumber(totals.muted);
+	out->append(" muted, ");
+	out->appendNumber(totals.away);
+	out->append(" away, ");
+	out->appendNumber(totals.query);
+	out->append(" query)");
+	return true;
+}
+
+/* Write "clients (n talking, n muted, n away)" for a channel or its family */
+static bool writeOccupancy(struct ServerShard* shard, uint64 channelID, bool family, TextWriter* out) {
+	struct ChannelCounts own = ChannelCounts();
+	struct ChannelCounts familyCounts = ChannelCounts();
+	{
+		std::lock_guard<std::mutex> lock(shard->worldMutex);
+		const World* world = renderedWorld(shard, PLUGIN_CHANNEL, channelID);
+		if (!world) {
+			out->append(WORLD_PLACEHOLDER);
+			return true;
+		}
+		world->counts(channelID, &own, &familyCounts);
+	}
+
+	const struct ChannelCounts& counts = family ? familyCounts : own;
+	out->appendNumber(counts.clients);
+	out->append(" (");
+	out->appendNumber(counts.talking);
+	out->append(" talking, ");
+	out->appendNumber(counts.muted);
+	out->append(" muted, ");
+	out->appendNumber(counts.away);
+	out->append(" away)");
+	return true;
+}
+
+/*
+ * Info fields
+ * Every item type has a table describing the lines of its info text. A field pairs a label with the property it shows
+ * and a renderer; for plain variables the renderer is instantiated from the value type and formatter, which selects the
+ * client library getter and the formatting at compile time. ts3plugin_infoData just walks the table of the selected item.
+ */
+struct InfoField;
+
+/* The item being rendered */
+struct RenderContext {
+	uint64 serverConnectionHandlerID;
+	struct ServerShard* shard;
+	enum PluginItemType type;
+	uint64 id;
+	struct RemoteClientInfo remote;  /* Clients only, snapshot taken before rendering */
+};
+
+/* Writes the value of a field, returns false if the field has no value and must be skipped */
+typedef bool (*FieldRenderer)(const struct RenderContext& context, const struct InfoField& field, TextWriter* out);
+
+/* Where the value of a field comes from, decides what profiles showing the field request from the server */
+enum FieldSource {
+	FIELD_LOCAL,             /* Client library, always up to date */
+	FIELD_PING,              /* requestConnectionInfo, only the integral part is shown */
+	FIELD_CONNECTION,        /* requestConnectionInfo, changes with every answer */
+	FIELD_CLIENT_VARIABLES,  /* requestClientVariables */
+};
+
+struct InfoField {
+	const char* label;
+	size_t flag;
+	FieldRenderer render;
+	enum FieldSource source;
+	unsigned int refresh;  /* Milliseconds the value stays correct if it changes with time, 0 if only events change it */
+};
+
+template <typename T, void (*Format)(TextWriter*, const T&)>
+static bool renderVariable(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	static thread_local T value;  /* Reused so strings keep their capacity between renders */
+	if (getVariable(context.shard, context.type, context.id, field.flag, &value) != ERROR_ok) {
+		printf("Error getting %s\n", field.label);
+		return false;
+	}
+	Format(out, value);
+	return true;
+}
+
+/* Client variable only known after requestClientVariables, a placeholder until the answer arrived */
+template <typename T, void (*Format)(TextWriter*, const T&)>
+static bool renderRemoteVariable(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	if (!context.remote.variablesReady) {
+		out->append(LOADING_PLACEHOLDER);
+		return true;
+	}
+	return renderVariable<T, Format>(context, field, out);
+}
+
+/* ID of the selected channel or client */
+static bool renderItemID(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	out->appendNumber(context.id);
+	return true;
+}
+
+/* Address of the server as seen by our own connection */
+static bool renderServerIP(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	anyID myid;
+	LibraryString serverIP;
+	if (ts3Functions.getClientID(context.serverConnectionHandlerID, &myid) != ERROR_ok ||
+		ts3Functions.getConnectionVariableAsString(context.serverConnectionHandlerID, myid, CONNECTION_SERVER_IP, serverIP.out()) != ERROR_ok) {
+		printf("Error getting %s\n", field.label);
+		return false;
+	}
+	out->append(serverIP.get());
+	return true;
+}
+
+/* Clients in the channel */
+static bool renderOccupancy(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	return writeOccupancy(context.shard, context.id, false, out);
+}
+
+/* Clients in the channel and its subchannels */
+static bool renderFamilyOccupancy(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	return writeOccupancy(context.shard, context.id, true, out);
+}
+
+/* Server dashboard, computed from the world model without walking the client or channel list */
+#define DASHBOARD_MAX_DEPTHS 16
+#define DASHBOARD_BUSIEST_CHANNELS 5
+#define DASHBOARD_TALKERS 10
+
+static bool renderServerClients(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	return writeServerOccupancy(context.shard, out);
+}
+
+/* "depth: clients" for each level of the channel tree, top level channels are depth 0 */
+static bool renderClientsPerDepth(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	int clients[DASHBOARD_MAX_DEPTHS];
+	size_t depths;
+	{
+		std::lock_guard<std::mutex> lock(context.shard->worldMutex);
+		const World* world = renderedWorld(context.shard, PLUGIN_SERVER, 0);
+		if (!world) {
+			out->append(WORLD_PLACEHOLDER);
+			return true;
+		}
+		depths = world->clientsPerDepth(clients, DASHBOARD_MAX_DEPTHS);
+	}
+	if (depths == 0) {
+		return false;
+	}
+	for (size_t i = 0; i < depths; ++i) {
+		if (i > 0) {
+			out->append(", ");
+		}
+		out->appendNumber(i);
+		out->append(": ");
+		out->appendNumber(clients[i]);
+	}
+	return true;
+}
+
+/* Channels with the most clients as "name (clients)" */
+static bool renderBusiestChannels(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	uint64 channelIDs[DASHBOARD_BUSIEST_CHANNELS];
+	int clients[DASHBOARD_BUSIEST_CHANNELS];
+	size_t count;
+	{
+		std::lock_guard<std::mutex> lock(context.shard->worldMutex);
+		const World* world = renderedWorld(context.shard, PLUGIN_SERVER, 0);
+		if (!world) {
+			out->append(WORLD_PLACEHOLDER);
+			return true;
+		}
+		count = world->busiestChannels(channelIDs, clients, DASHBOARD_BUSIEST_CHANNELS);
+	}
+	if (count == 0) {
+		return false;
+	}
+
+	static thread_local std::string name;
+	for (size_t i = 0; i < count; ++i) {
+		if (i > 0) {
+			out->append(", ");
+		}
+		if (getVariable(context.shard, PLUGIN_CHANNEL, channelIDs[i], CHANNEL_NAME, &name) == ERROR_ok) {
+			out->append(name.data(), name.length());
+		}
+		else {
+			out->appendNumber(channelIDs[i]);
+		}
+		out->append(" (");
+		out->appendNumber(clients[i]);
+		out->append(')');
+	}
+	return true;
+}
+
+/* Nicknames of the clients talking right now */
+static bool renderTalkers(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	anyID clientIDs[DASHBOARD_TALKERS];
+	size_t count;
+	int talking;
+	{
+		std::lock_guard<std::mutex> lock(context.shard->worldMutex);
+		const World* world = renderedWorld(context.shard, PLUGIN_SERVER, 0);
+		if (!world) {
+			out->append(WORLD_PLACEHOLDER);
+			return true;
+		}
+		count = world->talkers(clientIDs, DASHBOARD_TALKERS);
+		talking = world->totals().talking;
+	}
+	if (count == 0) {
+		out->append("none");
+		return true;
+	}
+
+	static thread_local std::string nickname;
+	for (size_t i = 0; i < count; ++i) {
+		if (i > 0) {
+			out->append(", ");
+		}
+		if (getVariable(context.shard, PLUGIN_CLIENT, clientIDs[i], CLIENT_NICKNAME, &nickname) == ERROR_ok) {
+			out->append(nickname.data(), nickname.length());
+		}
+		else {
+			out->appendNumber(clientIDs[i]);
+		}
+	}
+	if (talking > (int)count) {
+		out->append(" (+");
+		out->appendNumber(talking - (int)count);
+		out->append(')');
+	}
+	return true;
+}
+
+/* Comma separated server group IDs of a client, resolved to their names */
+static bool renderServerGroups(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	static thread_local std::string groups;
+	if (getVariable(context.shard, context.type, context.id, field.flag, &groups) != ERROR_ok) {
+		printf("Error getting %s\n", field.label);
+		return false;
+	}
+
+	bool resolved = true;
+	const char* position = groups.c_str();
+	const char* const end = position + groups.length();
+	while (position < end) {
+		uint64 groupID;
+		const std::from_chars_result result = std::from_chars(position, end, groupID);
+		if (result.ec != std::errc()) {
+			break;
+		}
+		if (position != groups.c_str()) {
+			out->append(", ");
+		}
+		resolved &= writeGroup(context.shard, true, groupID, out);
+		position = result.ptr + 1;  /* Skip the comma */
+	}
+	if (!resolved) {  /* Plugin loaded while already connected */
+		requestGroupLists(context.shard, true, false);
+	}
+	return true;
+}
+
+/* Channel group of a client, resolved to its name */
+static bool renderChannelGroup(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	uint64 groupID;
+	if (getVariable(context.shard, context.type, context.id, field.flag, &groupID) != ERROR_ok) {
+		printf("Error getting %s\n", field.label);
+		return false;
+	}
+	if (!writeGroup(context.shard, false, groupID, out)) {
+		requestGroupLists(context.shard, false, true);
+	}
+	return true;
+}
+
+/* Last known ping, ts3plugin_onConnectionInfoEvent refreshes the info frame once a newer one arrived */
+static bool renderPing(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	if (!context.remote.connectionValid) {
+		out->append(LOADING_PLACEHOLDER);
+		return true;
+	}
+	out->appendNumber((int)context.remote.connection.ping);  /* cast to int to lost .00000 */
+	return true;
+}
+
+/* Connection values need the answer to requestConnectionInfo, returns false after writing the placeholder */
+static bool connectionArrived(const struct RenderContext& context, TextWriter* out) {
+	if (!context.remote.connectionValid) {
+		out->append(LOADING_PLACEHOLDER);
+		return false;
+	}
+	return true;
+}
+
+static bool renderPingDeviation(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	if (connectionArrived(context, out)) {
+		out->appendFixed((uint64)(context.remote.connection.pingDeviation * 100 + 0.5), 2);
+	}
+	return true;
+}
+
+/* CONNECTION_CONNECTED_TIME or CONNECTION_IDLE_TIME */
+static bool renderConnectionTime(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	if (connectionArrived(context, out)) {
+		const struct ConnectionStats& stats = context.remote.connection;
+		out->appendDuration((field.flag == CONNECTION_CONNECTED_TIME ? stats.connectedTime : stats.idleTime) / 1000);
+	}
+	return true;
+}
+
+/* "ip:port", skipped if the server does not tell */
+static bool renderClientAddress(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	if (!connectionArrived(context, out)) {
+		return true;
+	}
+	if (context.remote.connection.clientIP[0] == '\0') {
+		return false;
+	}
+	out->append(context.remote.connection.clientIP);
+	out->append(':');
+	out->appendNumber(context.remote.connection.clientPort);
+	return true;
+}
+
+static void writeTraffic(TextWriter* out, uint64 value, bool bytes) {
+	if (bytes) {
+		out->appendBytes(value);
+	}
+	else {
+		out->appendNumber(value);
+	}
+}
+
+/* A group of packet or byte counters as "total (speech n, keepalive n, control n)" */
+static bool renderTraffic(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	static const char* const kinds[] = { "speech ", "keepalive ", "control " };
+	if (!connectionArrived(context, out)) {
+		return true;
+	}
+	const uint64* values = NULL;
+	for (size_t group = 0; group < sizeof(connectionCounters) / sizeof(connectionCounters[0]); ++group) {
+		if (connectionCounters[group].flag == field.flag) {
+			values = context.remote.connection.*connectionCounters[group].values;
+		}
+	}
+	assert(values);
+	const bool bytes = field.flag == CONNECTION_BYTES_SENT_SPEECH || field.flag == CONNECTION_BYTES_RECEIVED_SPEECH;
+	writeTraffic(out, values[CONNECTION_KINDS - 1], bytes);
+	for (size_t kind = 0; kind + 1 < CONNECTION_KINDS; ++kind) {
+		out->append(kind == 0 ? " (" : ", ");
+		out->append(kinds[kind]);
+		writeTraffic(out, values[kind], bytes);
+	}
+	out->append(')');
+	return true;
+}
+
+/* Bandwidth of the last second and averaged over the last minute, flag is the last second group */
+static bool renderBandwidth(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	if (!connectionArrived(context, out)) {
+		return true;
+	}
+	const struct ConnectionStats& stats = context.remote.connection;
+	const bool sent = field.flag == CONNECTION_BANDWIDTH_SENT_LAST_SECOND_SPEECH;
+	out->appendBytes((sent ? stats.bandwidthSentSecond : stats.bandwidthReceivedSecond)[CONNECTION_KINDS - 1]);
+	out->append("/s (last minute ");
+	out->appendBytes((sent ? stats.bandwidthSentMinute : stats.bandwidthReceivedMinute)[CONNECTION_KINDS - 1]);
+	out->append("/s)");
+	return true;
+}
+
+static void writePercent(TextWriter* out, float probability) {
+	out->appendFixed(probability > 0 ? (uint64)(probability * 10000 + 0.5f) : 0, 2);
+	out->append('%');
+}
+
+/* A group of packet loss probabilities as "total% (speech n%, keepalive n%, control n%)" */
+static bool renderPacketLoss(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	static const char* const kinds[] = { "speech ", "keepalive ", "control " };
+	if (!connectionArrived(context, out)) {
+		return true;
+	}
+	const float* values = NULL;
+	for (size_t group = 0; group < sizeof(connectionLosses) / sizeof(connectionLosses[0]); ++group) {
+		if (connectionLosses[group].flag == field.flag) {
+			values = context.remote.connection.*connectionLosses[group].values;
+		}
+	}
+	assert(values);
+	writePercent(out, values[CONNECTION_KINDS - 1]);
+	for (size_t kind = 0; kind + 1 < CONNECTION_KINDS; ++kind) {
+		out->append(kind == 0 ? " (" : ", ");
+		out->append(kinds[kind]);
+		writePercent(out, values[kind]);
+	}
+	out->append(')');
+	return true;
+}
+
+/* Copy of the talk record of the selected client, false if it has none */
+static bool talkRecord(const struct RenderContext& context, struct TalkRecord* record) {
+	std::lock_guard<std::mutex> lock(context.shard->talkMutex);
+	const struct TalkRecord* found = context.shard->talkTime.find((anyID)context.id);
+	if (!found) {
+		return false;
+	}
+	*record = *found;
+	return true;
+}
+
+/* "talk time (n% of the session), n utterances" */
+static bool renderTalkTime(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	struct TalkRecord record;
+	if (!talkRecord(context, &record)) {
+		return false;
+	}
+	const uint64 now = steadyMilliseconds();
+	const uint64 talkTime = TalkTime::totalTalkTime(record, now);
+	const uint64 session = now > record.sessionStart ? now - record.sessionStart : 0;
+	out->appendDuration(talkTime / 1000);
+	out->append(" (");
+	writePercent(out, session ? (float)talkTime / session : 0.0f);
+	out->append(" of the session), ");
+	out->appendNumber(record.utterances);
+	out->append(record.utterances == 1 ? " utterance" : " utterances");
+	return true;
+}
+
+/* Seconds with one decimal if they are not whole, without unit */
+static void writeSeconds(TextWriter* out, uint64 milliseconds) {
+	if (milliseconds % 1000) {
+		out->appendFixed(milliseconds / 100, 1);
+	}
+	else {
+		out->appendNumber(milliseconds / 1000);
+	}
+}
+
+/* Non empty buckets of the utterance length histogram as "<0.5s: n, 0.5-1s: n, ..., >32s: n" */
+static bool renderUtteranceLengths(const struct RenderContext& context, const struct InfoField& field, TextWriter* out) {
+	struct TalkRecord record;
+	if (!talkRecord(context, &record) || record.utterances == 0) {
+		return false;
+	}
+	bool first = true;
+	for (unsigned int i = 0; i < TALK_HISTOGRAM_BUCKETS; ++i) {
+		if (record.histogram[i] == 0) {
+			continue;
+		}
+		if (!first) {
+			out->append(", ");
+		}
+		first = false;
+		if (i == 0) {
+			out->append('<');
+			writeSeconds(out, TalkTime::bucketStart(1));
+		}
+		else if (i == TALK_HISTOGRAM_BUCKETS - 1) {
+			out->append('>');
+			writeSeconds(out, TalkTime::bucketStart(i));
+		}
+		else {
+			writeSeconds(out, TalkTime::bucketStart(i));
+			out->append('-');
+			writeSeconds(out, TalkTime::bucketStart(i + 1));
+		}
+		out->append("s: ");
+		out->appendNumber(record.histogram[i]);
+	}
+	return true;
+}
+
+template <typename T>
+constexpr struct InfoField variableField(const char* label, size_t flag) {
+	return { label, flag, &renderVariable<T, &writeValue>, FIELD_LOCAL, 0 };
+}
+
+template <typename T, void (*Format)(TextWriter*, const T&)>
+constexpr struct InfoField formattedField(const char* label, size_t flag) {
+	return { label, flag, &renderVariable<T, Format>, FIELD_LOCAL, 0 };
+}
+
+/* Fields needing requestClientVariables */
+template <typename T>
+constexpr struct InfoField remoteField(const char* label, size_t flag) {
+	return { label, flag, &renderRemoteVariable<T, &writeValue>, FIELD_CLIENT_VARIABLES, 0 };
+}
+
+template <typename T, void (*Format)(TextWriter*, const T&)>
+constexpr struct InfoField remoteFormattedField(const char* label, size_t flag) {
+	return { label, flag, &renderRemoteVariable<T, Format>, FIELD_CLIENT_VARIABLES, 0 };
+}
+
+constexpr struct InfoField customField(const char* label, FieldRenderer render) {
+	return { label, 0, render, FIELD_LOCAL, 0 };
+}
+
+/* Custom renderer of a variable */
+constexpr struct InfoField customField(const char* label, size_t flag, FieldRenderer render) {
+	return { label, flag, render, FIELD_LOCAL, 0 };
+}
+
+/* Durations and ages are shown in seconds */
+#define TIMED_FIELD_REFRESH_MS 1000
+
+/* A field whose value changes while no event arrives, texts showing it are rendered again after TIMED_FIELD_REFRESH_MS */
+constexpr struct InfoField timedField(struct InfoField field) {
+	return { field.label, field.flag, field.render, field.source, TIMED_FIELD_REFRESH_MS };
+}
+
+/* Fields shown from the ConnectionStats, flag is the first CONNECTION_* value they show */
+constexpr struct InfoField connectionField(const char* label, size_t flag, FieldRenderer render) {
+	return { label, flag, render, flag == CONNECTION_PING ? FIELD_PING : FIELD_CONNECTION, 0 };
+}
+
+static constexpr struct InfoField serverFields[] = {
+	variableField<std::string>("ServerUID", VIRTUALSERVER_UNIQUE_IDENTIFIER),
+	variableField<uint64>("Virtualserver ID", VIRTUALSERVER_ID),
+	customField("Serverip", &renderServerIP),
+	variableField<int>("Virtualserver Port", VIRTUALSERVER_PORT),
+	customField("Server Clients", &renderServerClients),
+	customField("Clients per Depth", &renderClientsPerDepth),
+	customField("Busiest Channels", &renderBusiestChannels),
+	customField("Talkers", &renderTalkers),
+};
+
+static constexpr struct InfoField channelFields[] = {
+	customField("Channel ID", &renderItemID),
+	customField("Clients", &renderOccupancy),
+	customField("Family Clients", &renderFamilyOccupancy),
+	variableField<uint64>("Order ID", CHANNEL_ORDER),
+	variableField<std::string>("Phoetic Channelname", CHANNEL_NAME_PHONETIC),
+	variableField<int>("Codec Quality", CHANNEL_CODEC_QUALITY),
+	variableField<int>("CHANNEL_FLAG_PERMANENT", CHANNEL_FLAG_PERMANENT),
+	variableField<int>("CHANNEL_FLAG_SEMI_PERMANENT", CHANNEL_FLAG_SEMI_PERMANENT),
+	variableField<int>("CHANNEL_FLAG_DEFAULT", CHANNEL_FLAG_DEFAULT),
+	variableField<int>("CHANNEL_FLAG_PASSWORD", CHANNEL_FLAG_PASSWORD),
+	variableField<int>("CHANNEL_CODEC_LATENCY_FACTOR", CHANNEL_CODEC_LATENCY_FACTOR),
+	variableField<int>("CHANNEL_CODEC_IS_UNENCRYPTED", CHANNEL_CODEC_IS_UNENCRYPTED),
+	variableField<int>("CHANNEL_DELETE_DELAY", CHANNEL_DELETE_DELAY),
+	variableField<int>("CHANNEL_FLAG_MAXCLIENTS_UNLIMITED", CHANNEL_FLAG_MAXCLIENTS_UNLIMITED),
+	variableField<int>("CHANNEL_FLAG_MAXFAMILYCLIENTS_UNLIMITED", CHANNEL_FLAG_MAXFAMILYCLIENTS_UNLIMITED),
+	variableField<int>("CHANNEL_FLAG_MAXFAMILYCLIENTS_INHERITED", CHANNEL_FLAG_MAXFAMILYCLIENTS_INHERITED),
+	variableField<int>("CHANNEL_FLAG_ARE_SUBSCRIBED", CHANNEL_FLAG_ARE_SUBSCRIBED),
+	variableField<int>("CHANNEL_NEEDED_TALK_POWER", CHANNEL_NEEDED_TALK_POWER),
+	variableField<int>("CHANNEL_FORCED_SILENCE", CHANNEL_FORCED_SILENCE),
+	variableField<int>("CHANNEL_ICON_ID", CHANNEL_ICON_ID),
+	variableField<int>("CHANNEL_FLAG_PRIVATE", CHANNEL_FLAG_PRIVATE),
+};
+
+static constexpr struct InfoField clientFields[] = {
+	customField("Client ID", &renderItemID),
+	variableField<std::string>("UID", CLIENT_UNIQUE_IDENTIFIER),
+	variableField<int>("DBID", CLIENT_DATABASE_ID),
+	customField("ServerGroups", CLIENT_SERVERGROUPS, &renderServerGroups),
+	remoteField<int>("Total Connections", CLIENT_TOTALCONNECTIONS),
+	connectionField("Ping", CONNECTION_PING, &renderPing),
+	connectionField("Ping Deviation", CONNECTION_PING_DEVIATION, &renderPingDeviation),
+	variableField<std::string>("Phonetic Nickname", CLIENT_NICKNAME_PHONETIC),
+	variableField<std::string>("Client Version Sign", CLIENT_VERSION_SIGN),
+	variableField<std::string>("Client BadgetIDs", CLIENT_BADGES),
+	variableField<std::string>("CLIENT_FLAG_TALKING", CLIENT_FLAG_TALKING),
+	variableField<std::string>("CLIENT_INPUT_MUTED", CLIENT_INPUT_MUTED),
+	variableField<std::string>("CLIENT_OUTPUT_MUTED", CLIENT_OUTPUT_MUTED),
+	variableField<std::string>("CLIENT_OUTPUTONLY_MUTED", CLIENT_OUTPUTONLY_MUTED),
+	variableField<std::string>("CLIENT_INPUT_HARDWARE", CLIENT_INPUT_HARDWARE),
+	variableField<std::string>("CLIENT_OUTPUT_HARDWARE", CLIENT_OUTPUT_HARDWARE),
+	variableField<std::string>("CLIENT_IS_RECORDING", CLIENT_IS_RECORDING),
+	customField("CLIENT_CHANNEL_GROUP_ID", CLIENT_CHANNEL_GROUP_ID, &renderChannelGroup),
+	timedField(customField("Talk Time", &renderTalkTime)),
+	customField("Utterance Lengths", &renderUtteranceLengths),
+	remoteFormattedField<uint64, &writeDate>("CLIENT_CREATED", CLIENT_CREATED),
+	timedField(remoteFormattedField<uint64, &writeDateAge>("CLIENT_LASTCONNECTED", CLIENT_LASTCONNECTED)),
+	variableField<std::string>("CLIENT_AWAY", CLIENT_AWAY),
+	variableField<std::string>("CLIENT_AWAY_MESSAGE", CLIENT_AWAY_MESSAGE),
+	variableField<std::string>("CLIENT_TYPE", CLIENT_TYPE),
+	variableField<std::string>("CLIENT_FLAG_AVATAR", CLIENT_FLAG_AVATAR),
+	variableField<std::string>("CLIENT_TALK_POWER", CLIENT_TALK_POWER),
+	variableField<std::string>("CLIENT_IS_TALKER", CLIENT_IS_TALKER),
+	remoteFormattedField<uint64, &writeBytes>("CLIENT_MONTH_BYTES_UPLOADED", CLIENT_MONTH_BYTES_UPLOADED),
+	remoteFormattedField<uint64, &writeBytes>("CLIENT_MONTH_BYTES_DOWNLOADED", CLIENT_MONTH_BYTES_DOWNLOADED),
+	remoteFormattedField<uint64, &writeBytes>("CLIENT_TOTAL_BYTES_UPLOADED", CLIENT_TOTAL_BYTES_UPLOADED),
+	remoteFormattedField<uint64, &writeBytes>("CLIENT_TOTAL_BYTES_DOWNLOADED", CLIENT_TOTAL_BYTES_DOWNLOADED),
+	variableField<std::string>("CLIENT_IS_PRIORITY_SPEAKER", CLIENT_IS_PRIORITY_SPEAKER),
+	variableField<std::string>("CLIENT_UNREAD_MESSAGES", CLIENT_UNREAD_MESSAGES),
+	variableField<std::string>("CLIENT_NEEDED_SERVERQUERY_VIEW_POWER", CLIENT_NEEDED_SERVERQUERY_VIEW_POWER),
+	variableField<std::string>("CLIENT_ICON_ID", CLIENT_ICON_ID),
+	variableField<std::string>("CLIENT_IS_CHANNEL_COMMANDER", CLIENT_IS_CHANNEL_COMMANDER),
+	variableField<std::string>("CLIENT_COUNTRY", CLIENT_COUNTRY),
+	variableField<std::string>("CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID", CLIENT_CHANNEL_GROUP_INHERITED_CHANNEL_ID),
+	variableField<std::string>("Client metadata", CLIENT_META_DATA),
+	timedField(connectionField("Connected Time", CONNECTION_CONNECTED_TIME, &renderConnectionTime)),
+	timedField(connectionField("Idle Time", CONNECTION_IDLE_TIME, &renderConnectionTime)),
+	connectionField("Client Address", CONNECTION_CLIENT_IP, &renderClientAddress),
+	connectionField("Packet Loss", CONNECTION_PACKETLOSS_SPEECH, &renderPacketLoss),
+	connectionField("Packet Loss Server to Client", CONNECTION_SERVER2CLIENT_PACKETLOSS_SPEECH, &renderPacketLoss),
+	connectionField("Packet Loss Client to Server", CONNECTION_CLIENT2SERVER_PACKETLOSS_SPEECH, &renderPacketLoss),
+	connectionField("Packets Sent", CONNECTION_PACKETS_SENT_SPEECH, &renderTraffic),
+	connectionField("Packets Received", CONNECTION_PACKETS_RECEIVED_SPEECH, &renderTraffic),
+	connectionField("Bytes Sent", CONNECTION_BYTES_SENT_SPEECH, &renderTraffic),
+	connectionField("Bytes Received", CONNECTION_BYTES_RECEIVED_SPEECH, &renderTraffic),
+	connectionField("Bandwidth Sent", CONNECTION_BANDWIDTH_SENT_LAST_SECOND_SPEECH, &renderBandwidth),
+	connectionField("Bandwidth Received", CONNECTION_BANDWIDTH_RECEIVED_LAST_SECOND_SPEECH, &renderBandwidth),
+};
+
+/*
+ * Field profiles
+ * The active profile decides which fields are shown. Disabled fields are skipped before their renderer runs, so they are
+ * never queried from the client library. Profiles are kept in PROFILE_FILENAME in the config path of the client.
+ */
+#define PROFILE_FILENAME "Informations.ini"
+#define DEFAULT_PROFILE "debug"
+#define ALL_FIELDS (~(uint64)0)
+
+static std::mutex profileMutex;
+static std::string profilePath;
+static struct FieldProfiles profiles;
+
+/* Bit i enables field i of the server, channel and client table, indexed by PluginItemType */
+static std::atomic<uint64> enabledFields[3] = { { ALL_FIELDS }, { ALL_FIELDS }, { ALL_FIELDS } };
+static std::atomic<bool> connectionEnabled(true);       /* Fields shown need requestConnectionInfo */
+static std::atomic<bool> connectionStatsEnabled(true);  /* and change with every answer */
+static std::atomic<bool> remoteVariablesEnabled(true);
+
+static void defaultProfiles(struct FieldProfiles* result) {
+	static const char* const minimal[] = {
+		"ServerUID", "Serverip", "Virtualserver Port",
+		"Channel ID", "CHANNEL_FLAG_PASSWORD", "CHANNEL_NEEDED_TALK_POWER",
+		"Client ID", "UID", "DBID", "Ping", "CLIENT_COUNTRY",
+	};
+	static const char* const moderator[] = {
+		"ServerUID", "Virtualserver ID", "Serverip", "Virtualserver Port", "Server Clients", "Busiest Channels", "Talkers",
+		"Channel ID", "Clients", "Family Clients", "Order ID", "CHANNEL_FLAG_PERMANENT", "CHANNEL_FLAG_SEMI_PERMANENT", "CHANNEL_FLAG_PASSWORD", "CHANNEL_NEEDED_TALK_POWER", "CHANNEL_FORCED_SILENCE",
+		"Client ID", "UID", "DBID", "ServerGroups", "CLIENT_CHANNEL_GROUP_ID", "Total Connections", "Ping", "Client Version Sign",
+		"CLIENT_IS_RECORDING", "CLIENT_CREATED", "CLIENT_LASTCONNECTED", "CLIENT_AWAY_MESSAGE", "CLIENT_TALK_POWER", "CLIENT_COUNTRY",
+		"Talk Time",
+	};
+	static const char* const connection[] = {
+		"Client ID", "UID", "Ping", "Ping Deviation", "Connected Time", "Idle Time", "Client Address",
+		"Packet Loss", "Packet Loss Server to Client", "Packet Loss Client to Server", "Packets Sent", "Packets Received",
+		"Bytes Sent", "Bytes Received", "Bandwidth Sent", "Bandwidth Received",
+	};
+
+	result->active = DEFAULT_PROFILE;
+	result->profiles.clear();
+	struct FieldProfile profile;
+	profile.name = "minimal";
+	profile.labels.assign(minimal, minimal + sizeof(minimal) / sizeof(minimal[0]));
+	result->profiles.push_back(profile);
+	profile.name = "moderator";
+	profile.labels.assign(moderator, moderator + sizeof(moderator) / sizeof(moderator[0]));
+	result->profiles.push_back(profile);
+	profile.name = "connection";
+	profile.labels.assign(connection, connection + sizeof(connection) / sizeof(connection[0]));
+	result->profiles.push_back(profile);
+	profile.name = DEFAULT_PROFILE;
+	profile.labels.assign(1, PROFILE_ALL_FIELDS);
+	result->profiles.push_back(profile);
+}
+
+/* Set the bit of every field in the table carrying label */
+template <size_t N>
+static bool enableField(const struct InfoField (&fields)[N], const std::string& label, uint64* mask) {
+	bool found = false;
+	for (size_t i = 0; i < N; ++i) {
+		if (label == fields[i].label) {
+			*mask |= (uint64)1 << i;
+			found = true;
+		}
+	}
+	return found;
+}
+
+template <size_t N>
+static bool fieldEnabled(const struct InfoField (&fields)[N], uint64 mask, enum FieldSource source) {
+	for (size_t i = 0; i < N; ++i) {
+		if (fields[i].source == source && (mask & ((uint64)1 << i))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Activate a profile, the caller holds profileMutex */
+static void applyProfile(const struct FieldProfile& profile) {
+	uint64 masks[3] = { 0, 0, 0 };
+	for (size_t i = 0; i < profile.labels.size(); ++i) {
+		const std::string& label = profile.labels[i];
+		if (label == PROFILE_ALL_FIELDS) {
+			masks[PLUGIN_SERVER] = masks[PLUGIN_CHANNEL] = masks[PLUGIN_CLIENT] = ALL_FIELDS;
+			continue;
+		}
+		bool found = enableField(serverFields, label, &masks[PLUGIN_SERVER]);
+		found = enableField(channelFields, label, &masks[PLUGIN_CHANNEL]) || found;
+		found = enableField(clientFields, label, &masks[PLUGIN_CLIENT]) || found;
+		if (!found) {
+			printf("Profile %s: unknown field %s\n", profile.name.c_str(), label.c_str());
+		}
+	}
+	for (int type = PLUGIN_SERVER; type <= PLUGIN_CLIENT; ++type) {
+		enabledFields[type] = masks[type];
+	}
+	connectionStatsEnabled = fieldEnabled(clientFields, masks[PLUGIN_CLIENT], FIELD_CONNECTION);
+	connectionEnabled = connectionStatsEnabled || fieldEnabled(clientFields, masks[PLUGIN_CLIENT], FIELD_PING);
+	remoteVariablesEnabled = fieldEnabled(clientFields, masks[PLUGIN_CLIENT], FIELD_CLIENT_VARIABLES);
+	profiles.active = profile.name;
+
+	/* Rendered texts were made with the previous selection */
+	clearRenderedInfo();
+}
+
+/* Read the profiles file and activate its profile, falling back to the built-in profiles */
+static void reloadProfiles() {
+	std::lock_guard<std::mutex> lock(profileMutex);
+	if (!loadFieldProfiles(profilePath.c_str(), &profiles) || profiles.profiles.empty()) {
+		defaultProfiles(&profiles);
+		if (!saveFieldProfiles(profilePath.c_str(), profiles)) {
+			printf("Error writing %s\n", profilePath.c_str());
+		}
+	}
+	const struct FieldProfile* profile = findFieldProfile(profiles, profiles.active);
+	if (!profile) {
+		printf("Unknown profile %s, using %s\n", profiles.active.c_str(), profiles.profiles[0].name.c_str());
+		profile = &profiles.profiles[0];
+	}
+	applyProfile(*profile);
+}
+
+static void loadProfiles(const char* configPath) {
+	{
+		std::lock_guard<std::mutex> lock(profileMutex);
+		profilePath = configPath;
+		profilePath += PROFILE_FILENAME;
+	}
+	reloadProfiles();
+}
+
+static void printProfiles() {
+	std::string message = "Field profiles:";
+	{
+		std::lock_guard<std::mutex> lock(profileMutex);
+		for (size_t i = 0; i < profiles.profiles.size(); ++i) {
+			message += profiles.profiles[i].name == profiles.active ? " [" : " ";
+			message += profiles.profiles[i].name;
+			message += profiles.profiles[i].name == profiles.active ? "]" : "";
+		}
+	}
+	ts3Functions.printMessageToCurrentTab(message.c_str());
+}
+
+static void selectProfile(const char* name) {
+	std::string message;
+	{
+		std::lock_guard<std::mutex> lock(profileMutex);
+		const struct FieldProfile* profile = findFieldProfile(profiles, name);
+		if (!profile) {
+			message = "Unknown field profile: ";
+			message += name;
+		}
+		else {
+			applyProfile(*profile);
+			if (!saveFieldProfiles(profilePath.c_str(), profiles)) {
+				printf("Error writing %s\n", profilePath.c_str());
+			}
+			message = "Field profile: ";
+			message += name;
+		}
+	}
+	ts3Functions.printMessageToCurrentTab(message.c_str());
+}
+
+/* Value of a field collected for the info text, label points into the static field table */
+struct RenderedField {
+	const char* label;
+	size_t labelLength;
+	size_t valueOffset;  /* Position of the value in the text of the value writer */
+	size_t valueLength;
+	bool cut;            /* The value did not fit, it is followed by CUT_MARKER */
+};
+
+#define FIELD_SEPARATOR " = "
+#define FIELD_SEPARATOR_LENGTH (sizeof(FIELD_SEPARATOR) - 1)
+#define CUT_MARKER "..."
+#define CUT_MARKER_LENGTH (sizeof(CUT_MARKER) - 1)
+#define MAX_INFO_FIELDS 64
+
+/* Length of the longest prefix of text not ending inside a UTF-8 sequence */
+static size_t utf8Prefix(const char* text, size_t length) {
+	size_t start = length;
+	while (start > 0 && ((unsigned char)text[start - 1] & 0xC0) == 0x80) {
+		--start;
+	}
+	if (start == 0) {
+		return length;
+	}
+	const unsigned char lead = (unsigned char)text[start - 1];
+	const size_t needed = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+	return length - (start - 1) >= needed ? length : start - 1;
+}
+
+/*
+ * Write the value of every field that has one, returns the number of collected fields. refresh is set to the shortest
+ * refresh of the collected fields, 0 if none of them changes with time. If values runs full the field that did not fit
+ * is kept cut at a character boundary and the fields after it are dropped.
+ */
+template <size_t N>
+static size_t renderFields(const struct InfoField (&fields)[N], const struct RenderContext& context, TextWriter* values, struct RenderedField* rendered, unsigned int* refresh) {
+	static_assert(N <= MAX_INFO_FIELDS, "Field table exceeds MAX_INFO_FIELDS");
+	const uint64 enabled = enabledFields[context.type];
+	size_t count = 0;
+	*refresh = 0;
+	for (size_t i = 0; i < N; ++i) {
+		if (!(enabled & ((uint64)1 << i))) {
+			continue;
+		}
+		const size_t offset = values->length();
+		if (!fields[i].render(context, fields[i], values)) {
+			values->rewind(offset);
+			if (values->truncated()) {
+				break;
+			}
+			continue;
+		}
+		rendered[count].label = fields[i].label;
+		rendered[count].labelLength = strlen(fields[i].label);
+		rendered[count].valueOffset = offset;
+		rendered[count].valueLength = values->length() - offset;
+		rendered[count].cut = values->truncated();
+		++count;
+		if (fields[i].refresh && (!*refresh || fields[i].refresh < *refresh)) {
+			*refresh = fields[i].refresh;
+		}
+		if (values->truncated()) {
+			rendered[count - 1].valueLength = utf8Prefix(values->data() + offset, rendered[count - 1].valueLength);
+			break;
+		}
+	}
+	return count;
+}
+
+/*
+ * Write the collected fields as "label = value" lines. The exact length is computed first, so the text is written
+ * straight into the single buffer handed to the client, which releases it with ts3plugin_freeMemory.
+ */
+static char* writeFields(const struct RenderedField* rendered, size_t count, const char* values) {
+	size_t length = 0;
+	for (size_t i = 0; i < count; ++i) {
+		length += (i ? 1 : 0) + rendered[i].labelLength + FIELD_SEPARATOR_LENGTH + rendered[i].valueLength;
+		length += rendered[i].cut ? CUT_MARKER_LENGTH : 0;
+	}
+
+	/* Must be allocated in the plugin! */
+	char* data = (char*)malloc((length + 1) * sizeof(char));
+	if (!data) {
+		return NULL;
+	}
+	char* out = data;
+	for (size_t i = 0; i < count; ++i) {
+		if (i) {
+			*out++ = '\n';
+		}
+		memcpy(out, rendered[i].label, rendered[i].labelLength);
+		out += rendered[i].labelLength;
+		memcpy(out, FIELD_SEPARATOR, FIELD_SEPARATOR_LENGTH);
+		out += FIELD_SEPARATOR_LENGTH;
+		memcpy(out, values + rendered[i].valueOffset, rendered[i].valueLength);
+		out += rendered[i].valueLength;
+		if (rendered[i].cut) {
+			memcpy(out, CUT_MARKER, CUT_MARKER_LENGTH);
+			out += CUT_MARKER_LENGTH;
+		}
+	}
+	*out = '\0';
+	assert((size_t)(out - data) == length);
+	return data;
+}
+
+/* Render the fields of the item in context, returns false for an unknown item type */
+static bool renderItem(const struct RenderContext& context, TextWriter* values, struct RenderedField* rendered, size_t* count, unsigned int* refresh) {
+	switch (context.type) {
+	case PLUGIN_SERVER:
+		*count = renderFields(serverFields, context, values, rendered, refresh);
+		return true;
+	case PLUGIN_CHANNEL:
+		*count = renderFields(channelFields, context, values, rendered, refresh);
+		return true;
+	case PLUGIN_CLIENT:
+		*count = renderFields(clientFields, context, values, rendered, refresh);
+		return true;
+	default:
+		return false;
+	}
+}
+
+void ts3plugin_infoData(uint64 serverConnectionHandlerID, uint64 id, enum PluginItemType type, char** data) {
+	struct RenderedField rendered[MAX_INFO_FIELDS];
+	char valueBuffer[INFODATA_BUFSIZE];
+	TextWriter values(valueBuffer, sizeof(valueBuffer));
+	size_t count;
+	unsigned int refresh;
+
+	const ShardPointer shard = findShard(serverConnectionHandlerID);
+	if (!shard) {
+		*data = NULL;  /* Not connected yet */
+		return;
+	}
+
+	struct RenderContext context;
+	context.serverConnectionHandlerID = serverConnectionHandlerID;
+	context.shard = shard.get();
+	context.type = type;
+	context.id = id;
+	{
+		std::lock_guard<std::mutex> lock(context.shard->requestMutex);
+		context.shard->requests.select(type == PLUGIN_CLIENT ? id : 0);
+	}
+	if (type == PLUGIN_CLIENT) {
+		/* Phase two: outdated remote data is requested in the background, even while the rendered text is reused */
+		getRemoteInfo(context.shard, (anyID)id, connectionEnabled, remoteVariablesEnabled, &context.remote);
+	}
+	else {
+		context.remote = RemoteClientInfo();
+	}
+
+	const struct InfoItem item = { type, type == PLUGIN_SERVER ? 0 : id };
+	uint64 generation = 0;
+	if ((*data = findRenderedInfo(context.shard, item, &generation)) != NULL) {
+		return;
+	}
+
+	if (!renderItem(context, &values, rendered, &count, &refresh)) {
+		printf("Invalid item type: %d\n", type);
+		*data = NULL;  /* Ignore */
+		return;
+	}
+	/* Long descriptions or away messages do not fit, render again into a larger buffer up to INFODATA_MAX_BUFSIZE */
+	std::vector<char> largeBuffer;
+	while (values.truncated() && largeBuffer.size() < INFODATA_MAX_BUFSIZE) {
+		largeBuffer.resize(largeBuffer.empty() ? 2 * INFODATA_BUFSIZE : 2 * largeBuffer.size());
+		values = TextWriter(&largeBuffer[0], largeBuffer.size());
+		renderItem(context, &values, rendered, &count, &refresh);
+	}
+	*data = writeFields(rendered, count, values.data());
+	if (*data) {
+		storeRenderedInfo(context.shard, item, generation, refresh, *data);
+	}
+}
+
+/* Required to release the memory for parameter "data" allocated in ts3plugin_infoData and ts3plugin_initMenus */
+void ts3plugin_freeMemory(void* data) {
+	free(data);
+}
+
+/*
+ * Plugin requests to be always automatically loaded by the TeamSpeak 3 client unless
+ * the user manually disabled it in the plugin dialog.
+ * This function is optional. If missing, no autoload is assumed.
+ */
+int ts3plugin_requestAutoload() {
+	return 0;  /* 1 = request autoloaded, 0 = do not request autoload */
+}
+
+/* Helper function to create a menu item */
+static struct PluginMenuItem* createMenuItem(enum PluginMenuType type, int id, const char* text, const char* icon) {
+	struct PluginMenuItem* menuItem = (struct PluginMenuItem*)malloc(sizeof(struct PluginMenuItem));
+	menuItem->type = type;
+	menuItem->id = id;
+	_strcpy(menuItem->text, PLUGIN_MENU_BUFSZ, text);
+	_strcpy(menuItem->icon, PLUGIN_MENU_BUFSZ, icon);
+	return menuItem;
+}
+
+/* Some makros to make the code to create menu items a bit more readable */
+#define BEGIN_CREATE_MENUS(x) const size_t sz = x + 1; size_t n = 0; *menuItems = (struct PluginMenuItem**)malloc(sizeof(struct PluginMenuItem*) * sz);
+#define CREATE_MENU_ITEM(a, b, c, d) (*menuItems)[n++] = createMenuItem(a, b, c, d);
+#define END_CREATE_MENUS (*menuItems)[n++] = NULL; assert(n == sz);
+
+
+
+/*
+ * Initialize plugin menus.
+ * This function is called after ts3plugin_init and ts3plugin_registerPluginID. A pluginID is required for plugin menus to work.
+ * Both ts3plugin_registerPluginID and ts3plugin_freeMemory must be implemented to use menus.
+ * If plugin menus are not used by a plugin, do not implement this function or return NULL.
+ */
+void ts3plugin_initMenus(struct PluginMenuItem*** menuItems, char** menuIcon) {
+	/*
+	 * Create the menus
+	 * There are three types of menu items:
+	 * - PLUGIN_MENU_TYPE_CLIENT:  Client context menu
+	 * - PLUGIN_MENU_TYPE_CHANNEL: Channel context menu
+	 * - PLUGIN_MENU_TYPE_GLOBAL:  "Plugins" menu in menu bar of main window
+	 *
+	 * Menu IDs are used to identify the menu item when ts3plugin_onMenuItemEvent is called
+	 *
+	 * The menu text is required, max length is 128 characters
+	 *
+	 * The icon is optional, max length is 128 characters. When not using icons, just pass an empty string.
+	 * Icons are loaded from a subdirectory in the TeamSpeak client plugins folder. The subdirectory must be named like the
+	 * plugin filename, without dll/so/dylib suffix
+	 * e.g. for "test_plugin.dll", icon "1.png" is loaded from <TeamSpeak 3 Client install dir>\plugins\test_plugin\1.png
+	 */
+
+	BEGIN_CREATE_MENUS(0);  /* IMPORTANT: Number of menu items must be correct! */
+	END_CREATE_MENUS;  /* Includes an assert checking if the number of menu items matched */
+
+	/*
+	 * Specify an optional icon for the plugin. This icon is used for the plugins submenu within context and main menus
+	 * If unused, set menuIcon to NULL
+	 */
+	*menuIcon = (char*)malloc(PLUGIN_MENU_BUFSZ * sizeof(char));
+	_strcpy(*menuIcon, PLUGIN_MENU_BUFSZ, "t.png");
+
+	/*
+	 * Menus can be enabled or disabled with: ts3Functions.setPluginMenuEnabled(pluginID, menuID, 0|1);
+	 * Test it with plugin command: /test enablemenu <menuID> <0|1>
+	 * Menus are enabled by default. Please note that shown menus will not automatically enable or disable when calling this function to
+	 * ensure Qt menus are not modified by any thread other the UI thread. The enabled or disable state will change the next time a
+	 * menu is displayed.
+	 */
+	/* For example, this would disable MENU_ID_GLOBAL_2: */
+	/* ts3Functions.setPluginMenuEnabled(pluginID, MENU_ID_GLOBAL_2, 0); */
+
+	/* All memory allocated in this function will be automatically released by the TeamSpeak client later by calling ts3plugin_freeMemory */
+}
+
+/* Helper function to create a hotkey */
+static struct PluginHotkey* createHotkey(const char* keyword, const char* description) {
+	struct PluginHotkey* hotkey = (struct PluginHotkey*)malloc(sizeof(struct PluginHotkey));
+	_strcpy(hotkey->keyword, PLUGIN_HOTKEY_BUFSZ, keyword);
+	_strcpy(hotkey->description, PLUGIN_HOTKEY_BUFSZ, description);
+	return hotkey;
+}
+
+/* Some makros to make the code to create hotkeys a bit more readable */
+#define BEGIN_CREATE_HOTKEYS(x) const size_t sz = x + 1; size_t n = 0; *hotkeys = (struct PluginHotkey**)malloc(sizeof(struct PluginHotkey*) * sz);
+#define CREATE_HOTKEY(a, b) (*hotkeys)[n++] = createHotkey(a, b);
+#define END_CREATE_HOTKEYS (*hotkeys)[n++] = NULL; assert(n == sz);
+
+/*
+ * Initialize plugin hotkeys. If your plugin does not use this feature, this function can be omitted.
+ * Hotkeys require ts3plugin_registerPluginID and ts3plugin_freeMemory to be implemented.
+ * This function is automatically called by the client after ts3plugin_init.
+ */
+void ts3plugin_initHotkeys(struct PluginHotkey*** hotkeys) {
+	/* Register hotkeys giving a keyword and a description.
+	 * The keyword will be later passed to ts3plugin_onHotkeyEvent to identify which hotkey was triggered.
+	 * The description is shown in the clients hotkey dialog. */
+	BEGIN_CREATE_HOTKEYS(0);  /* Create 3 hotkeys. Size must be correct for allocating memory. */
+	END_CREATE_HOTKEYS;
+
+	/* The client will call ts3plugin_freeMemory to release all allocated memory */
+}
+
+/*
+ * Event worker
+ * The ts3plugin_on* callbacks run on threads of the client library, which stall for as long as the plugin works on an
+ * event. The callbacks therefore only copy the event into a compact record on eventQueue, strings included, and return.
+ * A single worker thread, started in ts3plugin_init and joined in ts3plugin_shutdown, applies the records in order to
+ * the shards. The queue holds a whole connect storm: a server of 2000 clients and 200 channels coming back after a
+ * restart sends 12201 events (replay_events restart), faster than the worker applies them, and a 2048 record queue lost
+ * two thirds of them. With EVENT_QUEUE_SIZE neither that nor replay_events subscribe 500 20000 drops an event, at 3.4 MB.
+ * If the queue overflows anyway the dropped events cannot be replayed, so the worker applies what is still queued,
+ * throws away what the shards of the affected connections derived from events, seeds their worlds again and leaves the
+ * rest to be fetched from the client library on the next render. Overflows are logged as a warning, at most every
+ * EVENT_OVERFLOW_LOG_MS.
+ * The worker also appends the events of interest to the journal in the config path, see journal.h. Its write-behind
+ * buffer goes to disk when full or JOURNAL_FLUSH_MS after the last write, both on the worker.
+ */
+#define EVENT_QUEUE_SIZE 16384
+#define EVENT_TEXT_SIZE 128       /* Group names, messages and reasons, longer ones are cut and journaled as cut */
+#define EVENT_WORKER_IDLE_MS 100  /* Wake up this often even if no producer signalled */
+#define EVENT_OVERFLOW_LOG_MS 10000
+#define EVENT_LOG_BUFSIZE 256
+#define LOG_CHANNEL "Informations"
+#define JOURNAL_FILENAME "Informations.journal"
+#define JOURNAL_SEGMENT_SIZE (1024 * 1024)
+#define JOURNAL_SEGMENTS 8
+#define JOURNAL_BUFFER_SIZE (64 * 1024)
+#define JOURNAL_FLUSH_MS 1000
+
+enum PluginEventType {
+	EVENT_CONNECTED,
+	EVENT_DISCONNECTED,       /* Journal only, the shard is closed by the callback */
+	EVENT_CONNECTION_INFO,
+	EVENT_CHANNEL_ADDED,
+	EVENT_CHANNEL_CREATED,    /* Added by a client instead of listed on connect */
+	EVENT_CHANNEL_DELETED,
+	EVENT_CHANNEL_MOVED,
+	EVENT_CHANNEL_UPDATED,
+	EVENT_CHANNEL_EDITED,     /* Updated by a client instead of requested */
+	EVENT_CHANNEL_SUBSCRIBED,
+	EVENT_CHANNEL_UNSUBSCRIBED,
+	EVENT_SERVER_UPDATED,
+	EVENT_SERVER_EDITED,
+	EVENT_CLIENT_UPDATED,
+	EVENT_CLIENT_MOVED,
+	EVENT_CLIENT_SUBSCRIPTION, /* Came into or went out of view with its channel subscription */
+	EVENT_CLIENT_TIMEOUT,
+	EVENT_CLIENT_KICKED_CHANNEL,
+	EVENT_CLIENT_KICKED_SERVER,
+	EVENT_CLIENT_BANNED,
+	EVENT_TEXT_MESSAGE,       /* Journal only */
+	EVENT_TALK_STATUS,
+	EVENT_CHANNEL_GROUP_CHANGED,
+	EVENT_SERVER_GROUP_ADDED,
+	EVENT_SERVER_GROUP_DELETED,
+	EVENT_SERVER_GROUP,
+	EVENT_SERVER_GROUPS_FINISHED,
+	EVENT_CHANNEL_GROUP,
+	EVENT_CHANNEL_GROUPS_FINISHED,
+	EVENT_NAME,               /* Answer to a name lookup, text is the UID and the nickname, each terminated */
+	EVENT_EVENTS_DROPPED,     /* Journal only, posted by the worker itself: value events of the connection were lost */
+};
+
+struct PluginEvent {
+	uint64 serverConnectionHandlerID;
+	uint64 time;          /* Milliseconds since 1970 */
+	uint64 steadyTime;    /* steadyMilliseconds, for durations */
+	uint64 channelID;
+	uint64 parentID;      /* New parent of a channel */
+	uint64 oldChannelID;  /* Channel a client left */
+	uint64 groupID;
+	uint64 value;         /* Talk status, ban duration or text message target mode */
+	anyID clientID;
+	anyID invokerID;
+	unsigned short type;  /* PluginEventType */
+	bool textTruncated;   /* text holds the start of a longer one */
+	char text[EVENT_TEXT_SIZE];
+};
+
+static EventQueue<struct PluginEvent> eventQueue(EVENT_QUEUE_SIZE);
+static std::thread eventWorker;
+static std::atomic<bool> eventWorkerStop(false);
+static std::atomic<bool> eventWorkerIdle(false);  /* Waiting on eventWake, producers must signal */
+static std::mutex eventWakeMutex;
+static std::condition_variable eventWake;
+static std::atomic<bool> eventsDropped(false);
+static std::atomic<unsigned long long> droppedEvents(0);  /* In total, also those of closed connections */
+static unsigned long long resyncedDrops = 0;              /* Worker only, droppedEvents when it last resynced */
+static unsigned long long loggedDrops = 0;                /* Worker only, droppedEvents at the last warning */
+static unsigned int unloggedResyncs = 0;                  /* Worker only */
+static uint64 overflowLogged = 0;                         /* Worker only, steadyMilliseconds of the last warning */
+static JournalWriter journal;  /* Worker only */
+
+static struct PluginEvent newEvent(enum PluginEventType type, uint64 serverConnectionHandlerID) {
+	struct PluginEvent event;
+	event.serverConnectionHandlerID = serverConnectionHandlerID;
+	event.time = (uint64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	event.steadyTime = steadyMilliseconds();
+	event.channelID = 0;
+	event.parentID = 0;
+	event.oldChannelID = 0;
+	event.groupID = 0;
+	event.value = 0;
+	event.clientID = 0;
+	event.invokerID = 0;
+	event.type = (unsigned short)type;
+	event.textTruncated = false;
+	event.text[0] = '\0';
+	return event;
+}
+
+/* Copy text terminated into size bytes, cutting it at a UTF-8 character boundary if it does not fit. Returns true if cut. */
+static bool copyEventText(char* destination, size_t size, const char* text) {
+	size_t length = text ? strlen(text) : 0;
+	const bool truncated = length >= size;
+	if (truncated) {
+		length = size - 1;
+		while (length > 0 && (text[length] & 0xC0) == 0x80) {
+			--length;
+		}
+	}
+	if (length > 0) {
+		memcpy(destination, text, length);
+	}
+	destination[length] = '\0';
+	return truncated;
+}
+
+static void setEventText(struct PluginEvent* event, const char* text) {
+	event->textTruncated = copyEventText(event->text, EVENT_TEXT_SIZE, text);
+}
+
+/* Hand an event to the worker, never blocks */
+static void postEvent(const struct PluginEvent& event) {
+	if (!eventQueue.push(event)) {
+		++droppedEvents;
+		const ShardPointer shard = findShard(event.serverConnectionHandlerID);
+		if (shard) {
+			++shard->droppedEvents;
+		}
+		eventsDropped = true;
+		return;
+	}
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (eventWorkerIdle.exchange(false)) {
+		std::lock_guard<std::mutex> lock(eventWakeMutex);
+		eventWake.notify_one();
+	}
+}
+
+static void journalEvent(const struct PluginEvent& event);
+
+/*
+ * Events of some connections were dropped: forget everything derived from their events, the world is seeded again right
+ * away, the rest is fetched when rendering. Connections without drops keep their state. The journal gets a gap record
+ * with the number of dropped events before the events of the seed.
+ */
+static void resyncShards() {
+	std::vector<std::pair<ShardPointer, unsigned long long> > affected;
+	{
+		std::shared_lock<std::shared_mutex> lock(shardMutex);
+		for (std::unordered_map<uint64, ShardPointer>::const_iterator it = shards.begin(); it != shards.end(); ++it) {
+			const unsigned long long dropped = it->second->droppedEvents.exchange(0);
+			if (dropped > 0) {
+				affected.push_back(std::make_pair(it->second, dropped));
+			}
+		}
+	}
+	unloggedResyncs += (unsigned int)affected.size();
+	for (size_t i = 0; i < affected.size(); ++i) {
+		struct ServerShard* shard = affected[i].first.get();
+		struct PluginEvent gap = newEvent(EVENT_EVENTS_DROPPED, shard->serverConnectionHandlerID);
+		gap.value = affected[i].second;
+		journalEvent(gap);
+		{
+			std::lock_guard<std::mutex> lock(shard->propertyMutex);
+			shard->properties.clear();
+			++shard->propertyEpoch;
+		}
+		{
+			std::lock_guard<std::mutex> lock(shard->groupMutex);
+			shard->groups.serverGroupsReceived = false;
+			shard->groups.channelGroupsReceived = false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(shard->worldMutex);
+			shard->worldSeeded = false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(shard->talkMutex);
+			shard->talkTime.interrupt();
+		}
+		clearRenderedInfo(shard);
+		seedWorld(shard);
+	}
+}
+
+/*
+ * Warn about dropped events, the ones within EVENT_OVERFLOW_LOG_MS of the last warning are summed up into the next. The
+ * final call on shutdown warns about the rest.
+ */
+static void logDroppedEvents(uint64 now, bool final) {
+	const unsigned long long dropped = final ? droppedEvents.load() : resyncedDrops;
+	if (dropped == loggedDrops || (!final && overflowLogged != 0 && now - overflowLogged < EVENT_OVERFLOW_LOG_MS)) {
+		return;
+	}
+	char buffer[EVENT_LOG_BUFSIZE];
+	snprintf(buffer, sizeof(buffer), "Event queue overflow, %llu events dropped, server connections resynced %u times", dropped - loggedDrops, unloggedResyncs);
+	ts3Functions.logMessage(buffer, LogLevel_WARNING, LOG_CHANNEL, 0);
+	loggedDrops = dropped;
+	unloggedResyncs = 0;
+	overflowLogged = now;
+}
+
+/* Answer to requestConnectionInfo, the connection variables of the client are now up to date */
+static void connectionInfoArrived(struct ServerShard* shard, anyID clientID) {
+	struct ConnectionStats stats;
+	if (!readConnectionStats(shard->serverConnectionHandlerID, clientID, &stats)) {
+		printf("Error getting client Ping\n");
+		return;
+	}
+
+	bool changed;
+	bool repaint;
+	{
+		std::lock_guard<std::mutex> lock(shard->remoteInfoMutex);
+		struct RemoteClientInfo& info = shard->remoteInfo[clientID];
+		const bool pending = info.connectionPending;
+		/* Only the integral part of the ping is shown, the other connection values change with every answer */
+		changed = !info.connectionValid || (int)info.connection.ping != (int)stats.ping || connectionStatsEnabled;
+		info.connection = stats;
+		info.connectionValid = true;
+		info.connectionPending = false;
+		/* Only repaint when infoData asked for the values, the client itself requests connection infos as well */
+		repaint = pending && remoteInfoArrived(&info, changed);
+	}
+	if (changed) {
+		bumpGeneration(shard, PLUGIN_CLIENT, clientID);
+	}
+	if (repaint) {
+		ts3Functions.requestInfoUpdate(shard->serverConnectionHandlerID, PLUGIN_CLIENT, clientID);
+	}
+}
+
+/* Client variables changed, also the answer to requestClientVariables */
+static void clientUpdated(struct ServerShard* shard, anyID clientID) {
+	invalidateItem(shard, PLUGIN_CLIENT, clientID);
+	worldClientChanged(shard, clientID, -1);
+
+	bool repaint = false;
+	{
+		std::lock_guard<std::mutex> lock(shard->remoteInfoMutex);
+		std::unordered_map<anyID, struct RemoteClientInfo>::iterator it = shard->remoteInfo.find(clientID);
+		if (it != shard->remoteInfo.end() && it->second.variablesPending) {
+			it->second.variablesPending = false;
+			it->second.variablesReady = true;
+			repaint = remoteInfoArrived(&it->second, true);
+		}
+	}
+	if (repaint) {
+		ts3Functions.requestInfoUpdate(shard->serverConnectionHandlerID, PLUGIN_CLIENT, clientID);
+	}
+}
+
+/*
+ * Changes that come without an update event: moving changes the channel group, talking the talk flag
+ * and client IDs of clients leaving the server get reused.
+ */
+static void clientMoved(struct ServerShard* shard, anyID clientID, uint64 newChannelID) {
+	worldClientMoved(shard, clientID, newChannelID);
+	if (newChannelID == 0) {  /* Client left the server */
+		clientLeft(shard, clientID);
+		return;
+	}
+	invalidateItem(shard, PLUGIN_CLIENT, clientID);
+}
+
+/* Sessions start when a client enters and end when it leaves */
+static void talkClientMoved(struct ServerShard* shard, anyID clientID, uint64 oldChannelID, uint64 newChannelID, uint64 now) {
+	if (oldChannelID != 0 && newChannelID != 0) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(shard->talkMutex);
+	if (newChannelID == 0) {
+		shard->talkTime.left(clientID);
+	}
+	else {
+		shard->talkTime.entered(clientID, now);
+	}
+}
+
+/* A group list is complete, names replace the IDs shown so far */
+static void groupListFinished(struct ServerShard* shard, bool serverGroups) {
+	{
+		std::lock_guard<std::mutex> lock(shard->groupMutex);
+		if (serverGroups) {
+			shard->groups.serverGroupsPending = false;
+			shard->groups.serverGroupsReceived = true;
+		}
+		else {
+			shard->groups.channelGroupsPending = false;
+			shard->groups.channelGroupsReceived = true;
+		}
+	}
+	clearRenderedInfo(shard);
+}
+
+/* Journal record type of an event, 0 for events not journaled */
+static unsigned int journalType(unsigned short type) {
+	switch (type) {
+	case EVENT_CONNECTED:             return JOURNAL_CONNECTED;
+	case EVENT_DISCONNECTED:          return JOURNAL_DISCONNECTED;
+	case EVENT_CLIENT_MOVED:          return JOURNAL_CLIENT_MOVED;
+	case EVENT_CLIENT_TIMEOUT:        return JOURNAL_CLIENT_TIMEOUT;
+	case EVENT_CLIENT_KICKED_CHANNEL: return JOURNAL_CLIENT_KICKED_CHANNEL;
+	case EVENT_CLIENT_KICKED_SERVER:  return JOURNAL_CLIENT_KICKED_SERVER;
+	case EVENT_CLIENT_BANNED:         return JOURNAL_CLIENT_BANNED;
+	case EVENT_TALK_STATUS:           return JOURNAL_TALK_STATUS;
+	case EVENT_CLIENT_UPDATED:        return JOURNAL_CLIENT_UPDATED;
+	case EVENT_CHANNEL_CREATED:       return JOURNAL_CHANNEL_CREATED;
+	case EVENT_CHANNEL_DELETED:       return JOURNAL_CHANNEL_DELETED;
+	case EVENT_CHANNEL_MOVED:         return JOURNAL_CHANNEL_MOVED;
+	case EVENT_CHANNEL_EDITED:        return JOURNAL_CHANNEL_EDITED;
+	case EVENT_SERVER_EDITED:         return JOURNAL_SERVER_EDITED;
+	case EVENT_TEXT_MESSAGE:          return JOURNAL_TEXT_MESSAGE;
+	case EVENT_SERVER_GROUP_ADDED:    return JOURNAL_SERVER_GROUP_ADDED;
+	case EVENT_SERVER_GROUP_DELETED:  return JOURNAL_SERVER_GROUP_REMOVED;
+	case EVENT_CHANNEL_GROUP_CHANGED: return JOURNAL_CHANNEL_GROUP_CHANGED;
+	case EVENT_CLIENT_SUBSCRIPTION:   return JOURNAL_CLIENT_SUBSCRIPTION;
+	case EVENT_CHANNEL_SUBSCRIBED:    return JOURNAL_CHANNEL_SUBSCRIBED;
+	case EVENT_CHANNEL_UNSUBSCRIBED:  return JOURNAL_CHANNEL_UNSUBSCRIBED;
+	case EVENT_EVENTS_DROPPED:        return JOURNAL_EVENTS_DROPPED;
+	}
+	return 0;
+}
+
+static void journalEvent(const struct PluginEvent& event) {
+	struct JournalRecord record;
+	record.type = journalType(event.type);
+	if (!record.type || !journal.isOpen()) {
+		return;
+	}
+	record.time = event.time;
+	record.serverConnectionHandlerID = event.serverConnectionHandlerID;
+	record.clientID = event.clientID;
+	record.channelID = event.channelID;
+	record.otherChannelID = event.oldChannelID ? event.oldChannelID : event.parentID;
+	record.groupID = event.groupID;
+	record.invokerID = event.invokerID;
+	record.value = event.value;
+	record.text = event.text;
+	record.textLength = strlen(event.text);
+	record.textTruncated = event.textTruncated;
+	journal.append(record);
+}
+
+static void applyEvent(const struct PluginEvent& event) {
+	const ShardPointer shard = findShard(event.serverConnectionHandlerID);
+	if (!shard) {
+		return;  /* Disconnected meanwhile */
+	}
+
+	switch (event.type) {
+	case EVENT_CONNECTED:
+		openNameCache(shard.get());
+		requestGroupLists(shard.get(), true, true);
+		seedWorld(shard.get());
+		break;
+	case EVENT_CONNECTION_INFO:
+		requestCompleted(shard.get(), REQUEST_CONNECTION_INFO, event.clientID, event.steadyTime);
+		connectionInfoArrived(shard.get(), event.clientID);
+		break;
+	case EVENT_CHANNEL_ADDED:
+	case EVENT_CHANNEL_CREATED:
+		worldChannelAdded(shard.get(), event.channelID, event.parentID);
+		break;
+	case EVENT_CHANNEL_DELETED:
+		invalidateVariables(shard.get(), PLUGIN_CHANNEL, event.channelID);
+		forgetRenderedInfo(shard.get(), PLUGIN_CHANNEL, event.channelID);
+		worldChannelDeleted(shard.get(), event.channelID);
+		break;
+	case EVENT_CHANNEL_MOVED:
+		worldChannelMoved(shard.get(), event.channelID, event.parentID);
+		break;
+	case EVENT_CHANNEL_UPDATED:
+	case EVENT_CHANNEL_EDITED:
+	case EVENT_CHANNEL_SUBSCRIBED:
+	case EVENT_CHANNEL_UNSUBSCRIBED:
+		invalidateItem(shard.get(), PLUGIN_CHANNEL, event.channelID);
+		worldChannelUpdated(shard.get(), event.channelID);
+		break;
+	case EVENT_SERVER_UPDATED:
+	case EVENT_SERVER_EDITED:
+		invalidateItem(shard.get(), PLUGIN_SERVER, 0);
+		break;
+	case EVENT_CLIENT_UPDATED:
+		requestCompleted(shard.get(), REQUEST_CLIENT_VARIABLES, event.clientID, event.steadyTime);
+		clientUpdated(shard.get(), event.clientID);
+		break;
+	case EVENT_CLIENT_MOVED:
+	case EVENT_CLIENT_SUBSCRIPTION:
+	case EVENT_CLIENT_TIMEOUT:
+	case EVENT_CLIENT_KICKED_CHANNEL:
+	case EVENT_CLIENT_KICKED_SERVER:
+	case EVENT_CLIENT_BANNED:
+		clientMoved(shard.get(), event.clientID, event.channelID);
+		talkClientMoved(shard.get(), event.clientID, event.oldChannelID, event.channelID, event.steadyTime);
+		break;
+	case EVENT_TALK_STATUS:
+		worldClientChanged(shard.get(), event.clientID, event.value == STATUS_TALKING);
+		{
+			std::lock_guard<std::mutex> lock(shard->talkMutex);
+			shard->talkTime.talkStatus(event.clientID, event.value == STATUS_TALKING, event.steadyTime);
+		}
+		invalidateItem(shard.get(), PLUGIN_CLIENT, event.clientID);
+		break;
+	case EVENT_CHANNEL_GROUP_CHANGED:
+		invalidateItem(shard.get(), PLUGIN_CLIENT, event.clientID);
+		if (!knownGroup(shard.get(), false, event.groupID)) {  /* Group created after the list was received */
+			requestGroupLists(shard.get(), false, true);
+		}
+		break;
+	case EVENT_SERVER_GROUP_ADDED:
+		invalidateItem(shard.get(), PLUGIN_CLIENT, event.clientID);
+		if (!knownGroup(shard.get(), true, event.groupID)) {
+			requestGroupLists(shard.get(), true, false);
+		}
+		break;
+	case EVENT_SERVER_GROUP_DELETED:
+		invalidateItem(shard.get(), PLUGIN_CLIENT, event.clientID);
+		break;
+	case EVENT_SERVER_GROUP:
+	case EVENT_CHANNEL_GROUP: {
+		std::lock_guard<std::mutex> lock(shard->groupMutex);
+		(event.type == EVENT_SERVER_GROUP ? shard->groups.serverGroups : shard->groups.channelGroups)[event.groupID] = strings.intern(event.text);
+		break;
+	}
+	case EVENT_SERVER_GROUPS_FINISHED:
+		requestCompleted(shard.get(), REQUEST_SERVER_GROUP_LIST, 0, event.steadyTime);
+		groupListFinished(shard.get(), true);
+		break;
+	case EVENT_CHANNEL_GROUPS_FINISHED:
+		requestCompleted(shard.get(), REQUEST_CHANNEL_GROUP_LIST, 0, event.steadyTime);
+		groupListFinished(shard.get(), false);
+		break;
+	case EVENT_NAME:
+		rememberName(shard.get(), event.text, event.value, event.text + strlen(event.text) + 1, event.steadyTime);
+		break;
+	case EVENT_DISCONNECTED:
+	case EVENT_TEXT_MESSAGE:
+	case EVENT_EVENTS_DROPPED:
+		break;
+	}
+}
+
+static void runEventWorker() {
+	struct PluginEvent event;
+	std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+	for (;;) {
+		if (eventsDropped.exchange(false)) {
+			resyncedDrops = droppedEvents;
+			/* What is still queued predates the seed, applied after it it would roll the worlds back */
+			while (eventQueue.pop(&event)) {
+				journalEvent(event);
+				applyEvent(event);
+			}
+			resyncShards();
+		}
+		while (eventQueue.pop(&event)) {
+			journalEvent(event);
+			applyEvent(event);
+		}
+		logDroppedEvents(steadyMilliseconds(), false);
+		sendQueuedRequests();
+		if (eventWorkerStop) {
+			break;
+		}
+		if (journal.pending() > 0 && std::chrono::steady_clock::now() - lastFlush >= std::chrono::milliseconds(JOURNAL_FLUSH_MS)) {
+			journal.flush();
+			lastFlush = std::chrono::steady_clock::now();
+		}
+
+		std::unique_lock<std::mutex> lock(eventWakeMutex);
+		eventWorkerIdle = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (eventQueue.empty() && !eventWorkerStop) {
+			eventWake.wait_for(lock, std::chrono::milliseconds(EVENT_WORKER_IDLE_MS));
+		}
+		eventWorkerIdle = false;
+	}
+	logDroppedEvents(steadyMilliseconds(), true);
+}
+
+static void startEventWorker(const char* configPath) {
+	const std::string journalPath = std::string(configPath) + JOURNAL_FILENAME;
+	if (!journal.open(journalPath.c_str(), JOURNAL_SEGMENT_SIZE, JOURNAL_SEGMENTS, JOURNAL_BUFFER_SIZE)) {
+		printf("Journal disabled\n");
+	}
+	eventWorkerStop = false;
+	eventWorker = std::thread(runEventWorker);
+}
+
+/* Apply the events still queued and stop the worker */
+static void stopEventWorker() {
+	if (!eventWorker.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(eventWakeMutex);
+		eventWorkerStop = true;
+		eventWake.notify_one();
+	}
+	eventWorker.join();
+	journal.close();
+}
+
+/************************************** TeamSpeak callbacks ***************************************/
+
+void ts3plugin_onConnectionInfoEvent(uint64 serverConnectionHandlerID, anyID clientID) {
+	struct PluginEvent event = newEvent(EVENT_CONNECTION_INFO, serverConnectionHandlerID);
+	event.clientID = clientID;
+	postEvent(event);
+}
+
+/* The name cache is only written by the worker, the answer goes to it with the nickname cut to the room the UID leaves */
+static void postName(uint64 serverConnectionHandlerID, const char* uid, uint64 databaseID, const char* nickname) {
+	const size_t uidLength = uid ? strlen(uid) : 0;
+	if (uidLength == 0 || uidLength + 1 >= EVENT_TEXT_SIZE) {
+		return;  /* No UID, or longer than any the name cache stores */
+	}
+	struct PluginEvent event = newEvent(EVENT_NAME, serverConnectionHandlerID);
+	event.value = databaseID;
+	memcpy(event.text, uid, uidLength + 1);
+	copyEventText(event.text + uidLength + 1, EVENT_TEXT_SIZE - uidLength - 1, nickname);
+	postEvent(event);
+}
+
+void ts3plugin_onClientIDsEvent(uint64 serverConnectionHandlerID, const char* uniqueClientIdentifier, anyID clientID, const char* clientName) {
+	postName(serverConnectionHandlerID, uniqueClientIdentifier, 0, clientName);
+}
+
+void ts3plugin_onClientDBIDfromUIDEvent(uint64 serverConnectionHandlerID, const char* uniqueClientIdentifier, uint64 clientDatabaseID) {
+	postName(serverConnectionHandlerID, uniqueClientIdentifier, clientDatabaseID, NULL);
+}
+
+void ts3plugin_onClientNamefromUIDEvent(uint64 serverConnectionHandlerID, const char* uniqueClientIdentifier, uint64 clientDatabaseID, const char* clientNickName) {
+	postName(serverConnectionHandlerID, uniqueClientIdentifier, clientDatabaseID, clientNickName);
+}
+
+void ts3plugin_onClientNamefromDBIDEvent(uint64 serverConnectionHandlerID, const char* uniqueClientIdentifier, uint64 clientDatabaseID, const char* clientNickName) {
+	postName(serverConnectionHandlerID, uniqueClientIdentifier, clientDatabaseID, clientNickName);
+}
+
+/*
+ * Answers to return codes, also ERROR_ok ones, come straight to the scheduler so round trips are measured without the
+ * event queue. Returning 1 tells the client the answer was handled, it does not print errors of the plugin's requests.
+ */
+int ts3plugin_onServerErrorEvent(uint64 serverConnectionHandlerID, const char* errorMessage, unsigned int error, const char* returnCode, const char* extraMessage) {
+	return requestAnswered(serverConnectionHandlerID, returnCode, error, errorMessage) ? 1 : 0;
+}
+
+int ts3plugin_onServerPermissionErrorEvent(uint64 serverConnectionHandlerID, const char* errorMessage, unsigned int error, const char* returnCode, unsigned int failedPermissionID) {
+	return requestAnswered(serverConnectionHandlerID, returnCode, error, errorMessage) ? 1 : 0;
+}
+
+/* The worker opens the name cache, requests the group lists and seeds the world of an established connection */
+static void postConnected(uint64 serverConnectionHandlerID) {
+	postEvent(newEvent(EVENT_CONNECTED, serverConnectionHandlerID));
+}
+
+void ts3plugin_onConnectStatusChangeEvent(uint64 serverConnectionHandlerID, int newStatus, unsigned int errorNumber) {
+	if (newStatus == STATUS_CONNECTION_ESTABLISHED) {
+		openShard(serverConnectionHandlerID);
+		postConnected(serverConnectionHandlerID);
+	}
+	else if (newStatus == STATUS_DISCONNECTED) {
+		closeShard(serverConnectionHandlerID);
+		struct PluginEvent event = newEvent(EVENT_DISCONNECTED, serverConnectionHandlerID);
+		event.value = errorNumber;
+		postEvent(event);
+	}
+}
+
+void ts3plugin_onServerStopEvent(uint64 serverConnectionHandlerID, const char* shutdownMessage) {
+	closeShard(serverConnectionHandlerID);
+	struct PluginEvent event = newEvent(EVENT_DISCONNECTED, serverConnectionHandlerID);
+	setEventText(&event, shutdownMessage);
+	postEvent(event);
+}
+
+void ts3plugin_onNewChannelEvent(uint64 serverConnectionHandlerID, uint64 channelID, uint64 channelParentID) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_ADDED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	event.parentID = channelParentID;
+	postEvent(event);
+}
+
+void ts3plugin_onNewChannelCreatedEvent(uint64 serverConnectionHandlerID, uint64 channelID, uint64 channelParentID, anyID invokerID, const char* invokerName, const char* invokerUniqueIdentifier) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_CREATED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	event.parentID = channelParentID;
+	event.invokerID = invokerID;
+	postEvent(event);
+}
+
+void ts3plugin_onDelChannelEvent(uint64 serverConnectionHandlerID, uint64 channelID, anyID invokerID, const char* invokerName, const char* invokerUniqueIdentifier) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_DELETED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	event.invokerID = invokerID;
+	postEvent(event);
+}
+
+void ts3plugin_onChannelMoveEvent(uint64 serverConnectionHandlerID, uint64 channelID, uint64 newChannelParentID, anyID invokerID, const char* invokerName, const char* invokerUniqueIdentifier) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_MOVED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	event.parentID = newChannelParentID;
+	event.invokerID = invokerID;
+	postEvent(event);
+}
+
+void ts3plugin_onUpdateChannelEvent(uint64 serverConnectionHandlerID, uint64 channelID) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_UPDATED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	postEvent(event);
+}
+
+void ts3plugin_onUpdateChannelEditedEvent(uint64 serverConnectionHandlerID, uint64 channelID, anyID invokerID, const char* invokerName, const char* invokerUniqueIdentifier) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_EDITED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	event.invokerID = invokerID;
+	postEvent(event);
+}
+
+void ts3plugin_onChannelSubscribeEvent(uint64 serverConnectionHandlerID, uint64 channelID) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_SUBSCRIBED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	postEvent(event);
+}
+
+void ts3plugin_onChannelUnsubscribeEvent(uint64 serverConnectionHandlerID, uint64 channelID) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_UNSUBSCRIBED, serverConnectionHandlerID);
+	event.channelID = channelID;
+	postEvent(event);
+}
+
+void ts3plugin_onUpdateClientEvent(uint64 serverConnectionHandlerID, anyID clientID, anyID invokerID, const char* invokerName, const char* invokerUniqueIdentifier) {
+	struct PluginEvent event = newEvent(EVENT_CLIENT_UPDATED, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.invokerID = invokerID;
+	postEvent(event);
+}
+
+void ts3plugin_onServerUpdatedEvent(uint64 serverConnectionHandlerID) {
+	postEvent(newEvent(EVENT_SERVER_UPDATED, serverConnectionHandlerID));
+}
+
+void ts3plugin_onServerEditedEvent(uint64 serverConnectionHandlerID, anyID editerID, const char* editerName, const char* editerUniqueIdentifier) {
+	struct PluginEvent event = newEvent(EVENT_SERVER_EDITED, serverConnectionHandlerID);
+	event.invokerID = editerID;
+	postEvent(event);
+}
+
+static void postClientMoved(enum PluginEventType type, uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, anyID invokerID, const char* message) {
+	struct PluginEvent event = newEvent(type, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.oldChannelID = oldChannelID;
+	event.channelID = newChannelID;
+	event.invokerID = invokerID;
+	setEventText(&event, message);
+	postEvent(event);
+}
+
+void ts3plugin_onClientMoveEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility, const char* moveMessage) {
+	postClientMoved(EVENT_CLIENT_MOVED, serverConnectionHandlerID, clientID, oldChannelID, newChannelID, 0, moveMessage);
+}
+
+void ts3plugin_onClientMoveSubscriptionEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility) {
+	postClientMoved(EVENT_CLIENT_SUBSCRIPTION, serverConnectionHandlerID, clientID, oldChannelID, newChannelID, 0, NULL);
+}
+
+void ts3plugin_onClientMoveTimeoutEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility, const char* timeoutMessage) {
+	postClientMoved(EVENT_CLIENT_TIMEOUT, serverConnectionHandlerID, clientID, oldChannelID, newChannelID, 0, timeoutMessage);
+}
+
+void ts3plugin_onClientMoveMovedEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility, anyID moverID, const char* moverName, const char* moverUniqueIdentifier, const char* moveMessage) {
+	postClientMoved(EVENT_CLIENT_MOVED, serverConnectionHandlerID, clientID, oldChannelID, newChannelID, moverID, moveMessage);
+}
+
+void ts3plugin_onClientKickFromChannelEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility, anyID kickerID, const char* kickerName, const char* kickerUniqueIdentifier, const char* kickMessage) {
+	postClientMoved(EVENT_CLIENT_KICKED_CHANNEL, serverConnectionHandlerID, clientID, oldChannelID, newChannelID, kickerID, kickMessage);
+}
+
+void ts3plugin_onClientKickFromServerEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility, anyID kickerID, const char* kickerName, const char* kickerUniqueIdentifier, const char* kickMessage) {
+	postClientMoved(EVENT_CLIENT_KICKED_SERVER, serverConnectionHandlerID, clientID, oldChannelID, 0, kickerID, kickMessage);
+}
+
+void ts3plugin_onClientBanFromServerEvent(uint64 serverConnectionHandlerID, anyID clientID, uint64 oldChannelID, uint64 newChannelID, int visibility, anyID kickerID, const char* kickerName, const char* kickerUniqueIdentifier, uint64 time, const char* kickMessage) {
+	struct PluginEvent event = newEvent(EVENT_CLIENT_BANNED, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.oldChannelID = oldChannelID;
+	event.invokerID = kickerID;
+	event.value = time;
+	setEventText(&event, kickMessage);
+	postEvent(event);
+}
+
+int ts3plugin_onTextMessageEvent(uint64 serverConnectionHandlerID, anyID targetMode, anyID toID, anyID fromID, const char* fromName, const char* fromUniqueIdentifier, const char* message, int ffIgnored) {
+	struct PluginEvent event = newEvent(EVENT_TEXT_MESSAGE, serverConnectionHandlerID);
+	event.clientID = toID;
+	event.invokerID = fromID;
+	event.value = targetMode;
+	setEventText(&event, message);
+	postEvent(event);
+	return 0;  /* 0 = handle normally */
+}
+
+void ts3plugin_onTalkStatusChangeEvent(uint64 serverConnectionHandlerID, int status, int isReceivedWhisper, anyID clientID) {
+	struct PluginEvent event = newEvent(EVENT_TALK_STATUS, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.value = (uint64)status;
+	postEvent(event);
+}
+
+void ts3plugin_onClientChannelGroupChangedEvent(uint64 serverConnectionHandlerID, uint64 channelGroupID, uint64 channelID, anyID clientID, anyID invokerClientID, const char* invokerName, const char* invokerUniqueIdentity) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_GROUP_CHANGED, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.channelID = channelID;
+	event.groupID = channelGroupID;
+	event.invokerID = invokerClientID;
+	postEvent(event);
+}
+
+void ts3plugin_onServerGroupClientAddedEvent(uint64 serverConnectionHandlerID, anyID clientID, const char* clientName, const char* clientUniqueIdentity, uint64 serverGroupID, anyID invokerClientID, const char* invokerName, const char* invokerUniqueIdentity) {
+	struct PluginEvent event = newEvent(EVENT_SERVER_GROUP_ADDED, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.groupID = serverGroupID;
+	event.invokerID = invokerClientID;
+	postEvent(event);
+}
+
+void ts3plugin_onServerGroupClientDeletedEvent(uint64 serverConnectionHandlerID, anyID clientID, const char* clientName, const char* clientUniqueIdentity, uint64 serverGroupID, anyID invokerClientID, const char* invokerName, const char* invokerUniqueIdentity) {
+	struct PluginEvent event = newEvent(EVENT_SERVER_GROUP_DELETED, serverConnectionHandlerID);
+	event.clientID = clientID;
+	event.groupID = serverGroupID;
+	event.invokerID = invokerClientID;
+	postEvent(event);
+}
+
+/* Group lists, requested by the plugin or the client itself */
+void ts3plugin_onServerGroupListEvent(uint64 serverConnectionHandlerID, uint64 serverGroupID, const char* name, int type, int iconID, int saveDB) {
+	struct PluginEvent event = newEvent(EVENT_SERVER_GROUP, serverConnectionHandlerID);
+	event.groupID = serverGroupID;
+	setEventText(&event, name);
+	postEvent(event);
+}
+
+void ts3plugin_onServerGroupListFinishedEvent(uint64 serverConnectionHandlerID) {
+	postEvent(newEvent(EVENT_SERVER_GROUPS_FINISHED, serverConnectionHandlerID));
+}
+
+void ts3plugin_onChannelGroupListEvent(uint64 serverConnectionHandlerID, uint64 channelGroupID, const char* name, int type, int iconID, int saveDB) {
+	struct PluginEvent event = newEvent(EVENT_CHANNEL_GROUP, serverConnectionHandlerID);
+	event.groupID = channelGroupID;
+	setEventText(&event, name);
+	postEvent(event);
+}
+
+void ts3plugin_onChannelGroupListFinishedEvent(uint64 serverConnectionHandlerID) {
+	postEvent(newEvent(EVENT_CHANNEL_GROUPS_FINISHED, serverConnectionHandlerID));
+}
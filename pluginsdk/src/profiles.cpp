@@ -0,0 +1,94 @@
+/*
+ * Field profiles: named lists of info field labels, stored in a text file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "profiles.h"
+
+#define PROFILE_LINE_BUFSIZE 256
+#define PROFILE_ACTIVE_KEY "active="
+
+/* fopen, MSVC wants fopen_s */
+static FILE* openFile(const char* path, const char* mode) {
+#ifdef _WIN32
+	FILE* file;
+	return fopen_s(&file, path, mode) == 0 ? file : NULL;
+#else
+	return fopen(path, mode);
+#endif
+}
+
+/* Strip line breaks and surrounding blanks */
+static std::string trim(const char* line) {
+	const char* begin = line;
+	while (*begin == ' ' || *begin == '\t') {
+		++begin;
+	}
+	const char* end = begin + strlen(begin);
+	while (end > begin && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+		--end;
+	}
+	return std::string(begin, end);
+}
+
+bool loadFieldProfiles(const char* path, struct FieldProfiles* profiles) {
+	FILE* file = openFile(path, "r");
+	if (!file) {
+		return false;
+	}
+
+	profiles->active.clear();
+	profiles->profiles.clear();
+	char buffer[PROFILE_LINE_BUFSIZE];
+	while (fgets(buffer, sizeof(buffer), file)) {
+		const std::string line = trim(buffer);
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		if (line[0] == '[' && line[line.length() - 1] == ']') {
+			struct FieldProfile profile;
+			profile.name = line.substr(1, line.length() - 2);
+			profiles->profiles.push_back(profile);
+		}
+		else if (profiles->profiles.empty() && line.compare(0, strlen(PROFILE_ACTIVE_KEY), PROFILE_ACTIVE_KEY) == 0) {
+			profiles->active = line.substr(strlen(PROFILE_ACTIVE_KEY));
+		}
+		else if (!profiles->profiles.empty()) {
+			profiles->profiles.back().labels.push_back(line);
+		}
+		else {
+			printf("Ignoring line outside of a profile: %s\n", line.c_str());
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+bool saveFieldProfiles(const char* path, const struct FieldProfiles& profiles) {
+	FILE* file = openFile(path, "w");
+	if (!file) {
+		return false;
+	}
+
+	fprintf(file, "# Informations field profiles\n");
+	fprintf(file, "# Each [profile] lists the labels of the fields it shows, one per line, %s shows all fields.\n", PROFILE_ALL_FIELDS);
+	fprintf(file, "# Fields missing in the active profile are not queried at all. Switch with: /informations profile <name>\n");
+	fprintf(file, "%s%s\n", PROFILE_ACTIVE_KEY, profiles.active.c_str());
+	for (size_t i = 0; i < profiles.profiles.size(); ++i) {
+		fprintf(file, "\n[%s]\n", profiles.profiles[i].name.c_str());
+		for (size_t j = 0; j < profiles.profiles[i].labels.size(); ++j) {
+			fprintf(file, "%s\n", profiles.profiles[i].labels[j].c_str());
+		}
+	}
+	return fclose(file) == 0;
+}
+
+const struct FieldProfile* findFieldProfile(const struct FieldProfiles& profiles, const std::string& name) {
+	for (size_t i = 0; i < profiles.profiles.size(); ++i) {
+		if (profiles.profiles[i].name == name) {
+			return &profiles.profiles[i];
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,38 @@
+/*
+ * Field profiles: named lists of info field labels, stored in a text file
+ */
+
+#ifndef PROFILES_H
+#define PROFILES_H
+
+#include <string>
+#include <vector>
+
+/* Label selecting every field of every item type */
+#define PROFILE_ALL_FIELDS "*"
+
+struct FieldProfile {
+	std::string name;
+	std::vector<std::string> labels;
+};
+
+struct FieldProfiles {
+	std::string active;
+	std::vector<struct FieldProfile> profiles;
+};
+
+/*
+ * File format, lines starting with # are comments:
+ *   active=<profile name>
+ *   [<profile name>]
+ *   <field label>
+ *   ...
+ * Returns false if the file could not be read.
+ */
+bool loadFieldProfiles(const char* path, struct FieldProfiles* profiles);
+bool saveFieldProfiles(const char* path, const struct FieldProfiles& profiles);
+
+/* Returns NULL if there is no profile with that name */
+const struct FieldProfile* findFieldProfile(const struct FieldProfiles& profiles, const std::string& name);
+
+#endif
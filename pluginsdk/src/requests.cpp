@@ -0,0 +1,244 @@
+/*
+ * Request scheduling: deduplication, rate limiting and answer tracking of the requests a server connection sends to its
+ * server
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "requests.h"
+
+/* Return codes are looked up by hash, they are only kept while an answer may still come */
+#define RETURN_CODE_LIFETIME_MS (2 * REQUEST_ANSWER_TIMEOUT_MS)
+
+/* Requests about a single client, the ones given up once it is not selected anymore */
+static bool aboutClient(enum RequestCommand command) {
+	return command == REQUEST_CONNECTION_INFO || command == REQUEST_CLIENT_VARIABLES;
+}
+
+/* FNV-1a, never 0 as FlatMap keeps that free */
+static uint64 hashOf(const char* text) {
+	uint64 hash = 14695981039346656037ULL;
+	for (; *text; ++text) {
+		hash = (hash ^ (unsigned char)*text) * 1099511628211ULL;
+	}
+	return hash ? hash : 1;
+}
+
+static unsigned int bucketOf(uint64 milliseconds) {
+	unsigned int bucket = 0;
+	for (uint64 units = milliseconds / REQUEST_FASTEST_MS; units > 0 && bucket < REQUEST_LATENCY_BUCKETS - 1; units >>= 1) {
+		++bucket;
+	}
+	return bucket;
+}
+
+RequestScheduler::RequestScheduler() : tokens(REQUEST_DEFAULT_BURST), refilled(0), selected(0), totals() {
+	memset(latencies, 0, sizeof(latencies));
+	configure(REQUEST_DEFAULT_RATE, REQUEST_DEFAULT_BURST);
+}
+
+void RequestScheduler::configure(double rate, unsigned int burst) {
+	this->rate = rate;
+	this->burst = burst;
+	tokens = std::min(tokens, this->burst);
+}
+
+struct Request RequestScheduler::requestOf(uint64 key) {
+	const struct Request request = { (enum RequestCommand)((key >> 56) - 1), key & (((uint64)1 << 56) - 1) };
+	return request;
+}
+
+void RequestScheduler::refill(uint64 now) {
+	if (now > refilled) {
+		tokens = std::min(burst, tokens + (double)(now - refilled) * rate / 1000);
+		refilled = now;
+	}
+}
+
+void RequestScheduler::send(uint64 key, struct RequestState* state, uint64 now) {
+	state->sent = true;
+	state->time = now;
+	const struct Sent sent = { key, now };
+	sends.push_back(sent);
+	tokens -= 1;
+	++totals.issued;
+}
+
+bool RequestScheduler::current(const struct Sent& sent, struct RequestState** state) {
+	*state = requests.find(sent.key);
+	return *state && (*state)->sent && (*state)->time == sent.time;
+}
+
+void RequestScheduler::answer(uint64 key, const struct RequestState& state, uint64 now) {
+	const uint64 roundTrip = now > state.time ? now - state.time : 0;
+	struct RequestLatency& latency = latencies[requestOf(key).command];
+	++latency.answers;
+	latency.total += roundTrip;
+	latency.slowest = std::max(latency.slowest, roundTrip);
+	++latency.histogram[bucketOf(roundTrip)];
+}
+
+enum RequestDecision RequestScheduler::submit(enum RequestCommand command, uint64 id, bool urgent, uint64 now) {
+	const uint64 key = keyOf(command, id);
+	struct RequestState* known = requests.find(key);
+	if (known && (!known->sent || now - known->time < REQUEST_ANSWER_TIMEOUT_MS)) {
+		known->urgent |= urgent;
+		++totals.coalesced;
+		return REQUEST_COALESCED;
+	}
+
+	refill(now);
+	struct RequestState& state = requests[key];
+	state.urgent = urgent;
+	state.retries = 0;
+	if (tokens >= 1) {
+		send(key, &state, now);
+		return REQUEST_ISSUE;
+	}
+	state.sent = false;
+	state.time = now;
+	queue.push_back(key);
+	++totals.throttled;
+	return REQUEST_THROTTLED;
+}
+
+enum RequestDecision RequestScheduler::next(uint64 now, struct Request* request) {
+	/* Pending too long: queue it again if it is still needed, else give it up */
+	while (!sends.empty() && now - sends.front().time >= REQUEST_ANSWER_TIMEOUT_MS) {
+		const struct Sent timedOut = sends.front();
+		sends.pop_front();
+		struct RequestState* state;
+		if (!current(timedOut, &state)) {
+			continue;
+		}
+		++totals.timedOut;
+		*request = requestOf(timedOut.key);
+		if (state->retries < REQUEST_RETRIES && (state->urgent || !aboutClient(request->command) || request->id == selected)) {
+			state->sent = false;
+			state->time = now;
+			++state->retries;
+			queue.push_front(timedOut.key);
+			++totals.retried;
+			continue;
+		}
+		requests.erase(timedOut.key);
+		return REQUEST_EXPIRED;
+	}
+
+	/* Return codes whose answers will not come anymore */
+	while (!returnCodeOrder.empty()) {
+		const struct Sent* tagged = returnCodes.find(returnCodeOrder.front());
+		if (tagged && now - tagged->time < RETURN_CODE_LIFETIME_MS) {
+			break;
+		}
+		returnCodes.erase(returnCodeOrder.front());
+		returnCodeOrder.pop_front();
+	}
+
+	/* Keys answered or sent meanwhile, then requests waiting too long; the queue is in submit order, oldest first */
+	while (!queue.empty()) {
+		const struct RequestState* state = requests.find(queue.front());
+		if (!state || state->sent) {
+			queue.pop_front();
+			continue;
+		}
+		*request = requestOf(queue.front());
+		if (aboutClient(request->command) && request->id != selected && !state->urgent && now - state->time >= REQUEST_QUEUE_TIMEOUT_MS) {
+			requests.erase(queue.front());
+			queue.pop_front();
+			++totals.expired;
+			return REQUEST_EXPIRED;
+		}
+		break;
+	}
+	refill(now);
+	if (queue.empty() || tokens < 1) {
+		return REQUEST_IDLE;
+	}
+
+	/* The front is live, it goes unless a request for the selected client or an urgent one waits behind it */
+	size_t pick = 0;
+	for (size_t i = 0; i < queue.size(); ++i) {
+		const struct RequestState* state = requests.find(queue[i]);
+		if (!state || state->sent) {
+			continue;
+		}
+		const struct Request candidate = requestOf(queue[i]);
+		if (state->urgent || (aboutClient(candidate.command) && candidate.id == selected)) {
+			pick = i;
+			break;
+		}
+	}
+	const uint64 key = queue[pick];
+	queue.erase(queue.begin() + pick);
+	send(key, requests.find(key), now);
+	*request = requestOf(key);
+	return REQUEST_ISSUE;
+}
+
+void RequestScheduler::tag(enum RequestCommand command, uint64 id, const char* returnCode) {
+	const uint64 key = keyOf(command, id);
+	const struct RequestState* state = requests.find(key);
+	if (!state || !state->sent) {
+		return;
+	}
+	const uint64 hash = hashOf(returnCode);
+	const struct Sent sent = { key, state->time };
+	returnCodes[hash] = sent;
+	returnCodeOrder.push_back(hash);
+}
+
+enum RequestAnswer RequestScheduler::answered(const char* returnCode, bool succeeded, uint64 now, struct Request* request) {
+	const uint64 hash = hashOf(returnCode);
+	const struct Sent* tagged = returnCodes.find(hash);
+	if (!tagged) {
+		return REQUEST_ANSWER_UNKNOWN;
+	}
+	const struct Sent sent = *tagged;
+	returnCodes.erase(hash);
+	struct RequestState* state;
+	if (!current(sent, &state)) {
+		return REQUEST_ANSWER_STALE;
+	}
+	if (succeeded) {
+		answer(sent.key, *state, now);
+		requests.erase(sent.key);
+		return REQUEST_ANSWER_COMPLETED;
+	}
+	*request = requestOf(sent.key);
+	requests.erase(sent.key);
+	++totals.failed;
+	return REQUEST_ANSWER_FAILED;
+}
+
+void RequestScheduler::completed(enum RequestCommand command, uint64 id, uint64 now) {
+	const uint64 key = keyOf(command, id);
+	const struct RequestState* state = requests.find(key);
+	if (!state) {
+		return;
+	}
+	if (state->sent) {
+		answer(key, *state, now);
+	}
+	requests.erase(key);
+}
+
+void RequestScheduler::failed(enum RequestCommand command, uint64 id) {
+	if (requests.erase(keyOf(command, id))) {
+		++totals.failed;
+	}
+}
+
+size_t RequestScheduler::queued() const {
+	size_t count = 0;
+	requests.forEach([&count](uint64 key, const struct RequestState& state) {
+		if (!state.sent) {
+			++count;
+		}
+	});
+	return count;
+}
+
+size_t RequestScheduler::pending() const {
+	return requests.size() - queued();
+}
@@ -0,0 +1,147 @@
+/*
+ * Request scheduling: deduplication, rate limiting and answer tracking of the requests a server connection sends to its
+ * server
+ */
+
+#ifndef REQUESTS_H
+#define REQUESTS_H
+
+#include <deque>
+#include "teamspeak/public_definitions.h"
+#include "flatmap.h"
+
+#define REQUEST_DEFAULT_RATE 4     /* Requests per second, the default anti-flood of a server allows about twice that */
+#define REQUEST_DEFAULT_BURST 10
+#define REQUEST_ANSWER_TIMEOUT_MS 5000  /* A request without an answer by then is sent again or given up */
+#define REQUEST_RETRIES 1               /* Times a request still needed is sent again after a timeout */
+#define REQUEST_QUEUE_TIMEOUT_MS 10000  /* Requests for clients no longer selected are given up after waiting this long */
+
+/* Round trips shorter than REQUEST_FASTEST_MS, then one bucket per doubling, the last takes the rest */
+#define REQUEST_LATENCY_BUCKETS 8
+#define REQUEST_FASTEST_MS 25
+
+enum RequestCommand {
+	REQUEST_CONNECTION_INFO,   /* id is the client ID */
+	REQUEST_CLIENT_VARIABLES,  /* id is the client ID */
+	REQUEST_SERVER_GROUP_LIST,
+	REQUEST_CHANNEL_GROUP_LIST,
+	REQUEST_NAME_FROM_UID,     /* id is a hash of the UID, the caller keeps its text */
+	REQUEST_NAME_FROM_DBID,    /* id is the database ID */
+	REQUEST_COMMANDS
+};
+
+struct Request {
+	enum RequestCommand command;
+	uint64 id;
+};
+
+enum RequestDecision {
+	REQUEST_IDLE,       /* Nothing to send */
+	REQUEST_ISSUE,      /* Send the request now, a token was taken for it */
+	REQUEST_COALESCED,  /* An identical request is queued or waiting for its answer */
+	REQUEST_THROTTLED,  /* Queued until a token is available */
+	REQUEST_EXPIRED,    /* Waited too long in the queue or for its answer, give it up */
+};
+
+enum RequestAnswer {
+	REQUEST_ANSWER_UNKNOWN,    /* Not a return code of this scheduler */
+	REQUEST_ANSWER_STALE,      /* The request was answered by its events, sent again or given up meanwhile */
+	REQUEST_ANSWER_COMPLETED,
+	REQUEST_ANSWER_FAILED,     /* The server refused, give the request up */
+};
+
+struct RequestCounters {
+	uint64 issued;
+	uint64 coalesced;
+	uint64 throttled;
+	uint64 expired;    /* Given up in the queue */
+	uint64 failed;     /* Refused by the client library or the server */
+	uint64 timedOut;   /* No answer within REQUEST_ANSWER_TIMEOUT_MS */
+	uint64 retried;
+};
+
+/* Round trips of the answered requests of one command, in milliseconds */
+struct RequestLatency {
+	uint64 answers;
+	uint64 total;
+	uint64 slowest;
+	unsigned int histogram[REQUEST_LATENCY_BUCKETS];
+};
+
+/*
+ * Token bucket per server connection: a request takes a token, tokens come back at rate per second up to burst.
+ * Requests that find no token are queued and sent by whoever calls next(), requests for the selected client and urgent
+ * ones first, the others in order. A request identical to one queued or waiting for its answer is not sent again, so a
+ * burst of clicks on the same client makes one request.
+ * A sent request is pending until its events arrive or the server answers its return code. next() also finds the ones
+ * pending longer than REQUEST_ANSWER_TIMEOUT_MS: still needed ones are queued again REQUEST_RETRIES times, the others
+ * are given up. Times are milliseconds of a steady clock. Not thread safe.
+ */
+class RequestScheduler {
+public:
+	RequestScheduler();
+
+	void configure(double rate, unsigned int burst);
+	/* Client shown in the info frame, 0 if a server or channel is shown */
+	void select(uint64 clientID) { selected = clientID; }
+	/* Returns REQUEST_ISSUE, REQUEST_COALESCED or REQUEST_THROTTLED; urgent requests were typed by the user */
+	enum RequestDecision submit(enum RequestCommand command, uint64 id, bool urgent, uint64 now);
+	/* Returns REQUEST_ISSUE or REQUEST_EXPIRED for a queued or timed out request, REQUEST_IDLE if none is due */
+	enum RequestDecision next(uint64 now, struct Request* request);
+
+	/* Remember the return code a request is sent with, call before sending it */
+	void tag(enum RequestCommand command, uint64 id, const char* returnCode);
+	/* The server answered a return code; on REQUEST_ANSWER_FAILED request tells which request was given up */
+	enum RequestAnswer answered(const char* returnCode, bool succeeded, uint64 now, struct Request* request);
+	/* The events answering a request arrived, an identical request is sent again from now on */
+	void completed(enum RequestCommand command, uint64 id, uint64 now);
+	/* Give up a request, failed if the client library refused to send it */
+	void cancel(enum RequestCommand command, uint64 id) { requests.erase(keyOf(command, id)); }
+	void failed(enum RequestCommand command, uint64 id);
+
+	const struct RequestCounters& counters() const { return totals; }
+	const struct RequestLatency& latency(enum RequestCommand command) const { return latencies[command]; }
+	size_t queued() const;
+	size_t pending() const;
+	/* Lower bound of a latency bucket in milliseconds */
+	static uint64 bucketStart(unsigned int bucket) { return bucket ? (uint64)REQUEST_FASTEST_MS << (bucket - 1) : 0; }
+
+private:
+	struct RequestState {
+		uint64 time;    /* Queued or sent at */
+		bool sent;
+		bool urgent;
+		unsigned char retries;
+	};
+
+	/* A send of a request, outdated once the request is answered or sent again */
+	struct Sent {
+		uint64 key;
+		uint64 time;
+	};
+
+	/* Command in the top byte, 0 stays free for FlatMap */
+	static uint64 keyOf(enum RequestCommand command, uint64 id) { return ((uint64)(command + 1) << 56) | id; }
+	static struct Request requestOf(uint64 key);
+	void refill(uint64 now);
+	/* Mark a request sent now and take its token */
+	void send(uint64 key, struct RequestState* state, uint64 now);
+	/* state is the request of sent if that send is the latest one and not answered yet */
+	bool current(const struct Sent& sent, struct RequestState** state);
+	void answer(uint64 key, const struct RequestState& state, uint64 now);
+
+	FlatMap<uint64, struct RequestState> requests;  /* Queued or sent and not answered yet */
+	std::deque<uint64> queue;                       /* Keys in submit order, completed ones are skipped */
+	std::deque<struct Sent> sends;                  /* In send order, to find timeouts */
+	FlatMap<uint64, struct Sent> returnCodes;       /* By hash of the return code */
+	std::deque<uint64> returnCodeOrder;             /* Hashes in tag order, to forget old return codes */
+	double rate;
+	double burst;
+	double tokens;
+	uint64 refilled;
+	uint64 selected;
+	struct RequestCounters totals;
+	struct RequestLatency latencies[REQUEST_COMMANDS];
+};
+
+#endif
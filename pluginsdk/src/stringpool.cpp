@@ -0,0 +1,139 @@
+/*
+ * String interning: UIDs and group names kept once per process and referred to by 32 bit handles
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stringpool.h"
+
+#define BLOCK_ENTRIES (1u << STRING_POOL_BLOCK_BITS)
+
+/* FNV-1a */
+static unsigned int hashOf(const char* text, size_t length) {
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < length; ++i) {
+		hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+	}
+	return hash;
+}
+
+StringPool::StringPool() : count(0), chunkPosition(NULL), chunkFree(0), storageBytes(0) {
+	memset(blocks, 0, sizeof(blocks));
+	index.assign(1024, STRING_POOL_NONE);
+	intern("", 0);  /* STRING_POOL_EMPTY */
+}
+
+StringPool::~StringPool() {
+	for (size_t i = 0; i < STRING_POOL_MAX_BLOCKS && blocks[i]; ++i) {
+		delete[] blocks[i];
+	}
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		free(chunks[i]);
+	}
+}
+
+size_t StringPool::slotOf(const char* text, size_t length, unsigned int hash) const {
+	const size_t mask = index.size() - 1;
+	for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+		const unsigned int handle = index[i];
+		if (handle == STRING_POOL_NONE) {
+			return i;
+		}
+		const struct Entry& known = entry(handle);
+		if (known.hash == hash && known.length == length && memcmp(known.text, text, length) == 0) {
+			return i;
+		}
+	}
+}
+
+unsigned int StringPool::find(const char* text, size_t length) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return index[slotOf(text, length, hashOf(text, length))];
+}
+
+unsigned int StringPool::intern(const char* text, size_t length) {
+	const unsigned int hash = hashOf(text, length);
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t slot = slotOf(text, length, hash);
+	if (index[slot] != STRING_POOL_NONE) {
+		return index[slot];
+	}
+	if (count == (unsigned int)STRING_POOL_MAX_BLOCKS * BLOCK_ENTRIES) {
+		printf("String pool full, %u strings\n", count);
+		return STRING_POOL_EMPTY;
+	}
+
+	struct Entry*& block = blocks[count >> STRING_POOL_BLOCK_BITS];
+	if (!block) {
+		block = new struct Entry[BLOCK_ENTRIES];
+	}
+	struct Entry& added = block[count & (BLOCK_ENTRIES - 1)];
+	added.text = store(text, length);
+	added.length = (unsigned int)length;
+	added.hash = hash;
+	const unsigned int handle = count++;
+
+	index[slot] = handle;
+	if ((size_t)count * 4 > index.size() * 3) {
+		rehash(index.size() * 2);
+	}
+	return handle;
+}
+
+/* Copy text with its terminator into the current chunk, long texts get a chunk of their own */
+const char* StringPool::store(const char* text, size_t length) {
+	const size_t size = length + 1;
+	char* copy;
+	if (size > STRING_POOL_CHUNK_SIZE / 4) {
+		copy = (char*)malloc(size);
+		if (!copy) {
+			abort();
+		}
+		chunks.push_back(copy);
+		storageBytes += size;
+	}
+	else {
+		if (size > chunkFree) {
+			chunkPosition = (char*)malloc(STRING_POOL_CHUNK_SIZE);
+			if (!chunkPosition) {
+				abort();
+			}
+			chunks.push_back(chunkPosition);
+			chunkFree = STRING_POOL_CHUNK_SIZE;
+			storageBytes += STRING_POOL_CHUNK_SIZE;
+		}
+		copy = chunkPosition;
+		chunkPosition += size;
+		chunkFree -= size;
+	}
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+void StringPool::rehash(size_t capacity) {
+	index.assign(capacity, STRING_POOL_NONE);
+	const size_t mask = capacity - 1;
+	for (unsigned int handle = 0; handle < count; ++handle) {
+		size_t i = entry(handle).hash & mask;
+		while (index[i] != STRING_POOL_NONE) {
+			i = (i + 1) & mask;
+		}
+		index[i] = handle;
+	}
+}
+
+size_t StringPool::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return count;
+}
+
+size_t StringPool::bytes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t blockCount = 0;
+	while (blockCount < STRING_POOL_MAX_BLOCKS && blocks[blockCount]) {
+		++blockCount;
+	}
+	return sizeof(*this) + blockCount * BLOCK_ENTRIES * sizeof(struct Entry) + index.capacity() * sizeof(unsigned int) +
+	       chunks.capacity() * sizeof(char*) + storageBytes;
+}
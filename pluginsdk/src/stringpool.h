@@ -0,0 +1,71 @@
+/*
+ * String interning: UIDs and group names kept once per process and referred to by 32 bit handles
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <stddef.h>
+#include <string.h>
+#include <mutex>
+#include <vector>
+
+#define STRING_POOL_EMPTY 0            /* Handle of "", also what a zeroed handle refers to */
+#define STRING_POOL_NONE  0xFFFFFFFFu  /* Returned by find for strings never interned */
+#define STRING_POOL_BLOCK_BITS 12      /* Entries per block, 4096 */
+#define STRING_POOL_MAX_BLOCKS 4096    /* 16M strings */
+#define STRING_POOL_CHUNK_SIZE 65536   /* Text storage is allocated in chunks of this size */
+
+/*
+ * Equal strings get equal handles, so comparing handles compares strings. Texts are copied into large chunks and never
+ * move or get released before the pool is destroyed: intern identifiers and names that repeat, not text that changes
+ * with every update. intern and find lock the pool; text and length do not, a handle stays valid for any thread that
+ * got it through the usual synchronization.
+ */
+class StringPool {
+public:
+	StringPool();
+	~StringPool();
+	StringPool(const StringPool&) = delete;
+	StringPool& operator=(const StringPool&) = delete;
+
+	/* Handle of text, added if it is new */
+	unsigned int intern(const char* text, size_t length);
+	unsigned int intern(const char* text) { return intern(text, strlen(text)); }
+	/* Handle of text, STRING_POOL_NONE if it was never interned */
+	unsigned int find(const char* text, size_t length) const;
+
+	/* Null terminated text of a handle */
+	const char* text(unsigned int handle) const { return entry(handle).text; }
+	size_t length(unsigned int handle) const { return entry(handle).length; }
+
+	/* Number of strings, and bytes used for them including the index */
+	size_t size() const;
+	size_t bytes() const;
+
+private:
+	struct Entry {
+		const char* text;
+		unsigned int length;
+		unsigned int hash;
+	};
+
+	const struct Entry& entry(unsigned int handle) const {
+		return blocks[handle >> STRING_POOL_BLOCK_BITS][handle & ((1u << STRING_POOL_BLOCK_BITS) - 1)];
+	}
+	/* Slot of text in the index, holding STRING_POOL_NONE if it is not there */
+	size_t slotOf(const char* text, size_t length, unsigned int hash) const;
+	const char* store(const char* text, size_t length);
+	void rehash(size_t capacity);
+
+	mutable std::mutex mutex;
+	struct Entry* blocks[STRING_POOL_MAX_BLOCKS];
+	unsigned int count;
+	std::vector<unsigned int> index;  /* Open addressing table of handles */
+	std::vector<char*> chunks;
+	char* chunkPosition;
+	size_t chunkFree;
+	size_t storageBytes;  /* Chunks allocated for texts */
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Talk time accounting: how long and how often the clients of a server connection talk, from the talk status events
+ */
+
+#include "talktime.h"
+
+static unsigned int bucketOf(uint64 length) {
+	unsigned int bucket = 0;
+	for (uint64 units = length / TALK_SHORTEST_MS; units > 0 && bucket < TALK_HISTOGRAM_BUCKETS - 1; units >>= 1) {
+		++bucket;
+	}
+	return bucket;
+}
+
+void TalkTime::start(uint64 now) {
+	clients.clear();
+	started = now;
+}
+
+void TalkTime::entered(anyID clientID, uint64 now) {
+	struct TalkRecord& record = clients[clientID];
+	record = TalkRecord();  /* Client IDs of clients that left get reused */
+	record.sessionStart = now;
+}
+
+void TalkTime::talkStatus(anyID clientID, bool talking, uint64 now) {
+	struct TalkRecord* record = clients.find(clientID);
+	if (!record) {
+		if (!talking) {
+			return;  /* Started talking before tracking started */
+		}
+		record = &clients[clientID];
+		record->sessionStart = started;
+	}
+
+	if (talking) {
+		if (!record->talkingSince) {
+			record->talkingSince = now ? now : 1;
+		}
+		return;
+	}
+	if (!record->talkingSince) {
+		return;
+	}
+	const uint64 length = now > record->talkingSince ? now - record->talkingSince : 0;
+	record->talkingSince = 0;
+	record->talkTime += length;
+	++record->utterances;
+	++record->histogram[bucketOf(length)];
+}
+
+void TalkTime::interrupt() {
+	clients.forEach([](anyID clientID, struct TalkRecord& record) {
+		record.talkingSince = 0;
+	});
+}
+
+uint64 TalkTime::totalTalkTime(const struct TalkRecord& record, uint64 now) {
+	if (record.talkingSince && now > record.talkingSince) {
+		return record.talkTime + (now - record.talkingSince);
+	}
+	return record.talkTime;
+}
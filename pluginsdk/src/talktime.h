@@ -0,0 +1,50 @@
+/*
+ * Talk time accounting: how long and how often the clients of a server connection talk, from the talk status events
+ */
+
+#ifndef TALKTIME_H
+#define TALKTIME_H
+
+#include "teamspeak/public_definitions.h"
+#include "flatmap.h"
+
+/* Utterances shorter than TALK_SHORTEST_MS, then one bucket per doubling of the length, the last takes the rest */
+#define TALK_HISTOGRAM_BUCKETS 8
+#define TALK_SHORTEST_MS 500
+
+/* Times are milliseconds of a steady clock */
+struct TalkRecord {
+	uint64 sessionStart;      /* Client entered or the connection was established */
+	uint64 talkingSince;      /* 0 if not talking */
+	uint64 talkTime;          /* Sum of the finished utterances */
+	unsigned int utterances;
+	unsigned int histogram[TALK_HISTOGRAM_BUCKETS];
+};
+
+/*
+ * One fixed size record per client. Clients present before tracking started count their session from start(); a
+ * record is only added once they talk. Nothing is allocated per talk status change, only when a record is added.
+ */
+class TalkTime {
+public:
+	/* Forget all clients, sessions of clients already present start now */
+	void start(uint64 now);
+	void entered(anyID clientID, uint64 now);
+	void left(anyID clientID) { clients.erase(clientID); }
+	void talkStatus(anyID clientID, bool talking, uint64 now);
+	/* Talk status changes were lost, drop the utterances in progress */
+	void interrupt();
+
+	/* NULL if the client never talked and did not enter since start() */
+	const struct TalkRecord* find(anyID clientID) const { return clients.find(clientID); }
+	/* Talk time including the utterance in progress */
+	static uint64 totalTalkTime(const struct TalkRecord& record, uint64 now);
+	/* Lower bound of a bucket in milliseconds */
+	static uint64 bucketStart(unsigned int bucket) { return bucket ? (uint64)TALK_SHORTEST_MS << (bucket - 1) : 0; }
+
+private:
+	FlatMap<anyID, struct TalkRecord> clients;
+	uint64 started = 0;
+};
+
+#endif
@@ -0,0 +1,394 @@
+/*
+ * World model: the channel tree and client list of a server connection, mirrored from the client events
+ */
+
+#include "world.h"
+
+static void add(struct ChannelCounts* counts, const struct ChannelCounts& delta, int sign) {
+	counts->clients += sign * delta.clients;
+	counts->talking += sign * delta.talking;
+	counts->muted += sign * delta.muted;
+	counts->away += sign * delta.away;
+}
+
+/* Clients are listed as talkers while talking in a channel */
+static bool isTalker(const struct WorldClient& client) {
+	return (client.flags & WORLD_CLIENT_TALKING) && client.channelID != 0;
+}
+
+void World::addChannel(uint64 channelID, uint64 parentID, uint64 order, unsigned int flags) {
+	const struct WorldChannel* known = channels.find(channelID);
+	if (known) {
+		if (known->parentID != parentID) {
+			moveChannel(channelID, parentID, order);
+		}
+		updateChannel(channelID, order, flags);
+		return;
+	}
+	const struct WorldChannel* parent = channels.find(parentID);
+	const unsigned int depth = parent ? parent->depth + 1 : 0;
+	struct WorldChannel& channel = channels[channelID];
+	channel.parentID = parentID;
+	channel.order = order;
+	channel.flags = flags;
+	channel.depth = depth;
+	linkChild(channelID, &channel);
+}
+
+void World::updateChannel(uint64 channelID, uint64 order, unsigned int flags) {
+	struct WorldChannel* channel = channels.find(channelID);
+	if (channel) {
+		channel->order = order;
+		channel->flags = flags;
+	}
+}
+
+void World::moveChannel(uint64 channelID, uint64 parentID, uint64 order) {
+	struct WorldChannel* channel = channels.find(channelID);
+	if (!channel) {
+		return;
+	}
+	const struct ChannelCounts family = channel->family;
+	countFamily(channel->parentID, family, -1);
+	unlinkChild(*channel);
+	channel->parentID = parentID;
+	channel->order = order;
+	linkChild(channelID, channel);
+	countFamily(parentID, family, 1);
+	updateDepths(channelID);
+}
+
+void World::removeChannel(uint64 channelID) {
+	struct WorldChannel* channel = channels.find(channelID);
+	if (!channel) {
+		return;
+	}
+	/* The server empties channels before deleting them, left over clients stem from missed events */
+	for (anyID clientID = channel->firstClient; clientID != 0; ) {
+		struct WorldClient* client = clients.find(clientID);
+		count(*client, -1);
+		if (isTalker(*client)) {
+			unlistTalker(*client);
+		}
+		clientID = client->next;
+		client->channelID = 0;
+		client->previous = client->next = 0;
+	}
+	/* So are left over subchannels, they are cut loose and keep their depth */
+	for (uint64 childID = channel->firstChild; childID != 0; ) {
+		struct WorldChannel* child = channels.find(childID);
+		childID = child->nextSibling;
+		child->previousSibling = child->nextSibling = 0;
+	}
+	countFamily(channel->parentID, channel->family, -1);
+	unlinkChild(*channel);
+	channels.erase(channelID);
+}
+
+uint64 World::parentOf(uint64 channelID) const {
+	const struct WorldChannel* channel = channels.find(channelID);
+	return channel ? channel->parentID : 0;
+}
+
+void World::setClient(anyID clientID, uint64 channelID, unsigned int flags, unsigned int uid) {
+	struct WorldClient* client = clients.find(clientID);
+	if (client) {
+		count(*client, -1);
+		unlink(*client);
+		if (isTalker(*client)) {
+			unlistTalker(*client);
+		}
+	}
+	else {
+		client = &clients[clientID];
+	}
+	client->channelID = channelID;
+	client->flags = flags;
+	client->uid = uid;
+	link(clientID, client);
+	count(*client, 1);
+	if (isTalker(*client)) {
+		listTalker(clientID, client);
+	}
+}
+
+void World::removeClient(anyID clientID) {
+	const struct WorldClient* client = clients.find(clientID);
+	if (client) {
+		count(*client, -1);
+		unlink(*client);
+		if (isTalker(*client)) {
+			unlistTalker(*client);
+		}
+		clients.erase(clientID);
+	}
+}
+
+size_t World::clientsIn(uint64 channelID, anyID* clientIDs, size_t max) const {
+	const struct WorldChannel* channel = channels.find(channelID);
+	size_t count = 0;
+	for (anyID clientID = channel ? channel->firstClient : 0; clientID != 0 && count < max; clientID = clients.find(clientID)->next) {
+		clientIDs[count++] = clientID;
+	}
+	return count;
+}
+
+size_t World::channelPath(uint64 channelID, uint64* path, size_t max) const {
+	const struct WorldChannel* channel = channels.find(channelID);
+	if (!channel || channel->depth >= max) {
+		return 0;
+	}
+	const size_t length = channel->depth + 1;
+	for (size_t i = length; i > 0 && channelID != 0; --i) {
+		path[i - 1] = channelID;
+		channelID = parentOf(channelID);
+	}
+	return length;
+}
+
+bool World::counts(uint64 channelID, struct ChannelCounts* own, struct ChannelCounts* family) const {
+	const struct WorldChannel* channel = channels.find(channelID);
+	if (!channel) {
+		return false;
+	}
+	*own = channel->own;
+	*family = channel->family;
+	return true;
+}
+
+size_t World::clientsPerDepth(int* clients, size_t max) const {
+	size_t count = depthClients.size();
+	while (count > 0 && depthClients[count - 1] == 0) {  /* Skip empty levels at the bottom */
+		--count;
+	}
+	count = count < max ? count : max;
+	for (size_t i = 0; i < count; ++i) {
+		clients[i] = depthClients[i];
+	}
+	return count;
+}
+
+size_t World::busiestChannels(uint64* channelIDs, int* clients, size_t max) const {
+	size_t count = 0;
+	for (; count < max && count < ranking.size(); ++count) {
+		channelIDs[count] = ranking[count];
+		clients[count] = channels.find(ranking[count])->own.clients;
+	}
+	return count;
+}
+
+size_t World::talkers(anyID* clientIDs, size_t max) const {
+	size_t count = 0;
+	for (; count < max && count < talking.size(); ++count) {
+		clientIDs[count] = talking[count];
+	}
+	return count;
+}
+
+void World::clear() {
+	channels.clear();
+	clients.clear();
+	server = ServerCounts();
+	depthClients.clear();
+	ranking.clear();
+	rankFirst.clear();
+	rankLast.clear();
+	talking.clear();
+}
+
+void World::count(const struct WorldClient& client, int sign) {
+	struct WorldChannel* channel = channels.find(client.channelID);
+	if (!channel) {
+		return;
+	}
+	const struct ChannelCounts delta = {
+		1,
+		(client.flags & WORLD_CLIENT_TALKING) ? 1 : 0,
+		(client.flags & WORLD_CLIENT_MUTED) ? 1 : 0,
+		(client.flags & WORLD_CLIENT_AWAY) ? 1 : 0,
+	};
+	add(&channel->own, delta, sign);
+	add(&channel->family, delta, sign);
+	rank(client.channelID, channel, sign);
+	countFamily(channel->parentID, delta, sign);
+
+	server.clients += sign * delta.clients;
+	server.talking += sign * delta.talking;
+	server.muted += sign * delta.muted;
+	server.away += sign * delta.away;
+	server.query += (client.flags & WORLD_CLIENT_QUERY) ? sign : 0;
+	if (depthClients.size() <= channel->depth) {
+		depthClients.resize(channel->depth + 1, 0);
+	}
+	depthClients[channel->depth] += sign;
+}
+
+void World::countFamily(uint64 parentID, const struct ChannelCounts& family, int sign) {
+	while (parentID != 0) {
+		struct WorldChannel* parent = channels.find(parentID);
+		if (!parent) {
+			return;
+		}
+		add(&parent->family, family, sign);
+		parentID = parent->parentID;
+	}
+}
+
+void World::link(anyID clientID, struct WorldClient* client) {
+	struct WorldChannel* channel = channels.find(client->channelID);
+	client->previous = 0;
+	client->next = 0;
+	if (!channel) {
+		return;
+	}
+	client->next = channel->firstClient;
+	if (channel->firstClient != 0) {
+		clients.find(channel->firstClient)->previous = clientID;
+	}
+	channel->firstClient = clientID;
+}
+
+void World::unlink(const struct WorldClient& client) {
+	if (client.previous != 0) {
+		clients.find(client.previous)->next = client.next;
+	}
+	else {
+		struct WorldChannel* channel = channels.find(client.channelID);
+		if (channel) {
+			channel->firstClient = client.next;
+		}
+	}
+	if (client.next != 0) {
+		clients.find(client.next)->previous = client.previous;
+	}
+}
+
+void World::linkChild(uint64 channelID, struct WorldChannel* channel) {
+	struct WorldChannel* parent = channels.find(channel->parentID);
+	channel->previousSibling = 0;
+	channel->nextSibling = 0;
+	if (!parent) {
+		return;
+	}
+	channel->nextSibling = parent->firstChild;
+	if (parent->firstChild != 0) {
+		channels.find(parent->firstChild)->previousSibling = channelID;
+	}
+	parent->firstChild = channelID;
+}
+
+void World::unlinkChild(const struct WorldChannel& channel) {
+	if (channel.previousSibling != 0) {
+		channels.find(channel.previousSibling)->nextSibling = channel.nextSibling;
+	}
+	else {
+		struct WorldChannel* parent = channels.find(channel.parentID);
+		if (parent) {
+			parent->firstChild = channel.nextSibling;
+		}
+	}
+	if (channel.nextSibling != 0) {
+		channels.find(channel.nextSibling)->previousSibling = channel.previousSibling;
+	}
+}
+
+void World::updateDepths(uint64 channelID) {
+	struct WorldChannel* channel = channels.find(channelID);
+	const struct WorldChannel* parent = channels.find(channel->parentID);
+	const int shift = (int)(parent ? parent->depth + 1 : 0) - (int)channel->depth;
+	if (shift == 0) {
+		return;
+	}
+	/* The whole subtree moves by the same number of levels, walked in preorder through the child and sibling links */
+	for (uint64 id = channelID; ; ) {
+		const unsigned int depth = channel->depth + shift;
+		if (depthClients.size() <= depth) {
+			depthClients.resize(depth + 1, 0);
+		}
+		depthClients[channel->depth] -= channel->own.clients;
+		depthClients[depth] += channel->own.clients;
+		channel->depth = depth;
+
+		if (channel->firstChild != 0) {
+			id = channel->firstChild;
+			channel = channels.find(id);
+			continue;
+		}
+		while (id != channelID && channel->nextSibling == 0) {
+			id = channel->parentID;
+			channel = channels.find(id);
+		}
+		if (id == channelID) {
+			return;
+		}
+		id = channel->nextSibling;
+		channel = channels.find(id);
+	}
+}
+
+void World::rank(uint64 channelID, struct WorldChannel* channel, int sign) {
+	/*
+	 * Channels with the same number of clients are next to each other in ranking. A channel gaining a client is swapped
+	 * with the first one of its group and then ends the group above; one losing a client is swapped with the last one
+	 * and then starts the group below. Channels losing their last client leave from the end.
+	 */
+	const int clients = channel->own.clients;
+	const int before = clients - sign;
+	if ((int)rankFirst.size() <= clients) {
+		rankFirst.resize(clients + 1, 0);
+		rankLast.resize(clients + 1, -1);
+	}
+	if (sign > 0) {
+		int position = (int)ranking.size();
+		if (before == 0) {
+			channel->rank = (unsigned int)position;
+			ranking.push_back(channelID);
+		}
+		else {
+			position = rankFirst[before];
+			swapRanks(channel->rank, (unsigned int)position);
+			++rankFirst[before];
+		}
+		if (rankFirst[clients] > rankLast[clients]) {
+			rankFirst[clients] = position;
+		}
+		rankLast[clients] = position;
+	}
+	else {
+		const int position = rankLast[before];
+		swapRanks(channel->rank, (unsigned int)position);
+		--rankLast[before];
+		if (clients == 0) {
+			ranking.pop_back();
+			return;
+		}
+		if (rankFirst[clients] > rankLast[clients]) {
+			rankLast[clients] = position;
+		}
+		rankFirst[clients] = position;
+	}
+}
+
+void World::swapRanks(unsigned int a, unsigned int b) {
+	if (a == b) {
+		return;
+	}
+	const uint64 channelID = ranking[a];
+	ranking[a] = ranking[b];
+	ranking[b] = channelID;
+	channels.find(ranking[a])->rank = a;
+	channels.find(ranking[b])->rank = b;
+}
+
+void World::listTalker(anyID clientID, struct WorldClient* client) {
+	client->talker = (unsigned int)talking.size();
+	talking.push_back(clientID);
+}
+
+void World::unlistTalker(const struct WorldClient& client) {
+	/* The last one takes the place */
+	const anyID last = talking.back();
+	talking[client.talker] = last;
+	clients.find(last)->talker = client.talker;
+	talking.pop_back();
+}
@@ -0,0 +1,136 @@
+/*
+ * World model: the channel tree and client list of a server connection, mirrored from the client events
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <stddef.h>
+#include <vector>
+#include "teamspeak/public_definitions.h"
+#include "flatmap.h"
+
+/* WorldChannel flags */
+#define WORLD_CHANNEL_PERMANENT      0x01
+#define WORLD_CHANNEL_SEMI_PERMANENT 0x02
+#define WORLD_CHANNEL_DEFAULT        0x04
+#define WORLD_CHANNEL_PASSWORD       0x08
+#define WORLD_CHANNEL_SUBSCRIBED     0x10
+
+/* WorldClient flags */
+#define WORLD_CLIENT_TALKING 0x01
+#define WORLD_CLIENT_MUTED   0x02  /* Microphone or speakers muted */
+#define WORLD_CLIENT_AWAY    0x04
+#define WORLD_CLIENT_QUERY   0x08  /* ServerQuery client */
+
+#define WORLD_NO_UID 0xFFFFFFFFu
+
+struct ChannelCounts {
+	int clients;
+	int talking;
+	int muted;
+	int away;
+};
+
+/* Totals over all channels of a server connection */
+struct ServerCounts {
+	int clients;
+	int talking;
+	int muted;
+	int away;
+	int query;
+};
+
+struct WorldChannel {
+	uint64 parentID;          /* 0 for top level channels */
+	uint64 order;             /* ID of the channel sorted above, 0 for the first */
+	unsigned int flags;
+	unsigned int depth;       /* 0 for top level channels */
+	uint64 firstChild;        /* Subchannels, linked like the clients, 0 if there are none */
+	uint64 previousSibling;
+	uint64 nextSibling;
+	unsigned int rank;        /* Position in the ranking while the channel has clients */
+	anyID firstClient;        /* 0 if empty */
+	struct ChannelCounts own;
+	struct ChannelCounts family;  /* The channel and all subchannels */
+};
+
+struct WorldClient {
+	uint64 channelID;
+	anyID previous;           /* Clients of the same channel, 0 ends the list */
+	anyID next;
+	unsigned int flags;
+	unsigned int uid;         /* StringPool handle, WORLD_NO_UID if unknown */
+	unsigned int talker;      /* Position in the talker list while talking in a channel */
+};
+
+/*
+ * Channels and clients of one server connection in flat hash maps. Clients of a channel are linked into a list, so
+ * listing them costs the number of clients in the channel, and a channel path the depth of the channel. Every channel
+ * also stores the counts of its own clients and of its family, updated on every client change together with the
+ * server totals. Parents must be added before their subchannels; clients put into an unknown channel are not counted.
+ * Subchannels are linked to their parent, so moving a channel only visits its subtree to update the depths. The
+ * channels with clients are kept ranked by their number of clients and the talking clients in a list, so the busiest
+ * channels and the talkers are read without looking at the other channels and clients.
+ */
+class World {
+public:
+	bool hasChannel(uint64 channelID) const { return channels.find(channelID) != NULL; }
+	const struct WorldChannel* findChannel(uint64 channelID) const { return channels.find(channelID); }
+	void addChannel(uint64 channelID, uint64 parentID, uint64 order, unsigned int flags);
+	void updateChannel(uint64 channelID, uint64 order, unsigned int flags);
+	void moveChannel(uint64 channelID, uint64 parentID, uint64 order);
+	void removeChannel(uint64 channelID);
+	/* 0 for top level and unknown channels */
+	uint64 parentOf(uint64 channelID) const;
+
+	const struct WorldClient* findClient(anyID clientID) const { return clients.find(clientID); }
+	/* Add a client or move it and update its flags */
+	void setClient(anyID clientID, uint64 channelID, unsigned int flags, unsigned int uid);
+	void removeClient(anyID clientID);
+
+	/* Up to max clients of a channel, returns the number written */
+	size_t clientsIn(uint64 channelID, anyID* clientIDs, size_t max) const;
+	/* IDs from the top level channel down to channelID, returns the depth + 1 or 0 if the path is longer than max */
+	size_t channelPath(uint64 channelID, uint64* path, size_t max) const;
+
+	/* Returns false if the channel is unknown */
+	bool counts(uint64 channelID, struct ChannelCounts* own, struct ChannelCounts* family) const;
+	const struct ServerCounts& totals() const { return server; }
+	/* Clients in channels of depth 0 (top level), 1, ... up to max depths, returns the number of depths written */
+	size_t clientsPerDepth(int* clients, size_t max) const;
+	/* Up to max channels with the most clients, most crowded first, returns the number written */
+	size_t busiestChannels(uint64* channelIDs, int* clients, size_t max) const;
+	/* Up to max talking clients, returns the number written */
+	size_t talkers(anyID* clientIDs, size_t max) const;
+
+	void clear();
+
+private:
+	/* Add (sign 1) or remove (sign -1) a client to the counts of its channel, the parents and the server totals */
+	void count(const struct WorldClient& client, int sign);
+	/* Add the family counts of a channel to its parents */
+	void countFamily(uint64 parentID, const struct ChannelCounts& family, int sign);
+	void link(anyID clientID, struct WorldClient* client);
+	void unlink(const struct WorldClient& client);
+	void linkChild(uint64 channelID, struct WorldChannel* channel);
+	void unlinkChild(const struct WorldChannel& channel);
+	/* Shift the depths of a moved channel and its subchannels and the clients per depth */
+	void updateDepths(uint64 channelID);
+	/* Move a channel in the ranking after its number of clients changed by sign */
+	void rank(uint64 channelID, struct WorldChannel* channel, int sign);
+	void swapRanks(unsigned int a, unsigned int b);
+	void listTalker(anyID clientID, struct WorldClient* client);
+	void unlistTalker(const struct WorldClient& client);
+
+	FlatMap<uint64, struct WorldChannel> channels;
+	FlatMap<anyID, struct WorldClient> clients;
+	struct ServerCounts server = ServerCounts();
+	std::vector<int> depthClients;
+	std::vector<uint64> ranking;  /* Channels with clients, most crowded first */
+	std::vector<int> rankFirst;   /* By number of clients, first and last position of those channels in ranking */
+	std::vector<int> rankLast;    /* First > last if there are none */
+	std::vector<anyID> talking;
+};
+
+#endif